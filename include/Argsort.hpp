@@ -0,0 +1,68 @@
+#ifndef ARGSORT_HPP
+#define ARGSORT_HPP
+
+#include <cstdint>
+#include <utility>
+
+// Indeks rekordu porównywany według wartości rekordu. Ma 4 bajty, więc algorytmy
+// z SortingAlgorithms.hpp przestawiają indeksy zamiast dużych obiektów (np. BoardGame).
+// Tablica rekordów jest wskazywana przez base - ustawia ją argsort() na czas sortowania.
+template<typename T>
+struct ArgIndex {
+    uint32_t index;
+
+    static inline thread_local const T *base = nullptr;
+
+    bool operator>(const ArgIndex &other) const {
+        return base[index] > base[other.index];
+    }
+
+    bool operator<=(const ArgIndex &other) const {
+        return base[index] <= base[other.index];
+    }
+};
+
+// Zwraca permutację perm (new[]), dla której arr[perm[0]], arr[perm[1]], ... jest posortowane.
+// sort(ArgIndex<T> *idx, int n) to wybrany algorytm sortowania; arr nie jest modyfikowane.
+template<typename T, typename Sort>
+uint32_t *argsort(const T *arr, int n, Sort sort) {
+    auto *idx = new ArgIndex<T>[n];
+    for (int i = 0; i < n; ++i) {
+        idx[i].index = static_cast<uint32_t>(i);
+    }
+
+    const T *previous_base = ArgIndex<T>::base;
+    ArgIndex<T>::base = arr;
+    sort(idx, n);
+    ArgIndex<T>::base = previous_base;
+
+    auto *perm = new uint32_t[n];
+    for (int i = 0; i < n; ++i) {
+        perm[i] = idx[i].index;
+    }
+    delete[] idx;
+    return perm;
+}
+
+// Ustawia rekordy w miejscu tak, że arr[i] = (stare) arr[perm[i]], przechodząc po cyklach
+// permutacji. Każdy rekord jest przenoszony raz, dodatkowo potrzebny jest tylko jeden rekord
+// tymczasowy. perm jest zużywana (na koniec zawiera permutację identycznościową).
+template<typename T>
+void apply_permutation(T *arr, uint32_t *perm, int n) {
+    for (int i = 0; i < n; ++i) {
+        if (perm[i] == static_cast<uint32_t>(i)) continue;
+
+        T temp = std::move(arr[i]);
+        int j = i;
+        while (perm[j] != static_cast<uint32_t>(i)) {
+            int next = static_cast<int>(perm[j]);
+            arr[j] = std::move(arr[next]);
+            perm[j] = static_cast<uint32_t>(j);
+            j = next;
+        }
+        arr[j] = std::move(temp);
+        perm[j] = static_cast<uint32_t>(j);
+    }
+}
+
+#endif
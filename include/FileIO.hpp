@@ -1,7 +1,9 @@
 #ifndef FILEIO_HPP
 #define FILEIO_HPP
 
+#include <cstdint>
 #include <string>
+#include <vector>
 #include <fstream>
 #include <stdexcept>
 
@@ -24,6 +26,28 @@ T *load_data(const std::string &filename, int &size) {
     return data;
 }
 
+// Wczytanie do istniejącego bufora - przy kolejnych plikach pamięć bufora jest używana ponownie.
+// Bufor jest czyszczony przed resize(), więc plik krótszy niż jego nagłówek daje puste wartości
+// (jak load_data z new[]), a nie rekordy z poprzedniego pliku
+template<typename T>
+void load_data(const std::string &filename, std::vector<T> &data) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+
+    int size;
+    file >> size;
+    file.ignore();
+
+    data.clear();
+    data.resize(size);
+
+    for (int i = 0; i < size; ++i) {
+        file >> data[i];
+    }
+}
+
 template<typename T>
 void save_data(const std::string &filename, const T *arr, int size) {
     std::ofstream file(filename);
@@ -37,4 +61,18 @@ void save_data(const std::string &filename, const T *arr, int size) {
     }
 }
 
+// Zapis w kolejności permutacji (np. z argsort) - rekordy nie są przestawiane w pamięci
+template<typename T>
+void save_data(const std::string &filename, const T *arr, const uint32_t *perm, int size) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file for writing: " + filename);
+    }
+
+    file << size << '\n';
+    for (int i = 0; i < size; ++i) {
+        file << arr[perm[i]] << '\n';
+    }
+}
+
 #endif
@@ -0,0 +1,18 @@
+#ifndef JSON_HPP
+#define JSON_HPP
+
+#include <map>
+#include <string>
+
+// Płaski obiekt JSON z jednej linii, np. {"algorithm": 3, "input": "in.txt", "argsort": true}.
+// Zagnieżdżone obiekty i tablice nie są obsługiwane; wartości są przechowywane jako tekst.
+using JsonObject = std::map<std::string, std::string>;
+
+// raw (opcjonalnie) dostaje wartości w postaci JSON - liczby dosłownie, napisy w cudzysłowie -
+// żeby można je było odesłać bez zmiany typu
+JsonObject parse_json_object(const std::string &line, JsonObject *raw = nullptr);
+
+// Napis w cudzysłowie z ucieczkami JSON
+std::string json_quote(const std::string &text);
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef MEASUREMENT_HPP
+#define MEASUREMENT_HPP
+
+#include <cstddef>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+// Stan pamięci podręcznej przed mierzonym obszarem
+enum class CacheMode { DEFAULT, COLD, WARM };
+
+// Ustawienia pomiaru zapisywane razem z wynikiem
+struct MeasurementSettings {
+    int cpu{-1};               // rdzeń, do którego przypięto wątek (-1 - brak przypięcia)
+    CacheMode cache{CacheMode::DEFAULT};
+    bool prefault{false};
+};
+
+const char *cache_mode_name(CacheMode mode);
+
+// Przypina bieżący wątek do rdzenia (sched_setaffinity); false gdy się nie udało
+bool pin_to_cpu(int cpu);
+
+// Przypięcie na czas życia obiektu: zapamiętuje maskę rdzeni wątku (sched_getaffinity)
+// i przywraca ją w destruktorze, więc kolejne zadania tego samego wątku nie są przypięte
+class ScopedCpuPin {
+public:
+    explicit ScopedCpuPin(int cpu);
+
+    ~ScopedCpuPin();
+
+    ScopedCpuPin(const ScopedCpuPin &) = delete;
+
+    ScopedCpuPin &operator=(const ScopedCpuPin &) = delete;
+
+    bool pinned() const;
+
+private:
+    bool active;
+#ifdef __linux__
+    cpu_set_t saved;
+#endif
+};
+
+// Wypycha dane z pamięci podręcznej, przechodząc po buforze większym niż LLC
+void flush_caches();
+
+// Odczytuje (albo przepisuje tą samą wartością) każdą linię pamięci podręcznej bloku
+void touch_memory(void *data, std::size_t bytes, bool write);
+
+// Przygotowuje stertę na alokacje w mierzonym obszarze: blok scratch_bytes jest zapisywany
+// i zwalniany, a alokator (glibc) nie oddaje go systemowi, więc kolejne alokacje trafiają
+// w strony, które już wystąpiły. Ustawienia mallopt zostają do końca procesu.
+void prefault_heap(std::size_t scratch_bytes);
+
+// Przygotowanie danych arr przed startem Timera według ustawień
+template<typename T>
+void prepare_measurement(const MeasurementSettings &settings, T *arr, int size) {
+    if (settings.prefault) {
+        touch_memory(arr, sizeof(T) * size, true);
+        prefault_heap((sizeof(T) + 16) * static_cast<std::size_t>(size));
+    }
+    if (settings.cache == CacheMode::COLD) {
+        flush_caches();
+    } else if (settings.cache == CacheMode::WARM) {
+        touch_memory(arr, sizeof(T) * size, false);
+    }
+}
+
+#endif
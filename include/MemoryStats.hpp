@@ -0,0 +1,56 @@
+#ifndef MEMORYSTATS_HPP
+#define MEMORYSTATS_HPP
+
+#include <cstddef>
+
+// Wyniki pomiaru pamięci dla jednego przebiegu sortowania
+struct MemoryStats {
+    long peak_rss_kb;               // szczytowe RSS procesu (VmHWM / ru_maxrss)
+    std::size_t allocated_bytes;    // suma bajtów zaalokowanych w mierzonym obszarze
+    std::size_t peak_scratch_bytes; // szczytowa dodatkowa pamięć sterty ponad stan z start()
+    int max_depth;                  // maksymalna głębokość rekurencji algorytmu
+};
+
+// Mierzy zużycie pamięci pomiędzy start() i stop(), analogicznie do Timer.
+// Alokacje są zliczane przez globalny operator new zdefiniowany w MemoryStats.cpp.
+class MemoryTracker {
+public:
+    MemoryTracker();
+
+    void start();
+
+    void stop();
+
+    MemoryStats result() const;
+
+private:
+    std::size_t allocated_at_start;
+    std::size_t live_at_start;
+    MemoryStats stats;
+    bool running;
+};
+
+// Licznik głębokości rekurencji. Algorytmy rekurencyjne tworzą DepthGuard<CountDepth> na wejściu;
+// przy CountDepth = false (domyślnie) strażnik jest pusty i kompiluje się do niczego, więc
+// zwykłe przebiegi nie płacą za pomiar (np. rekurencja ogonowa w heapify zostaje pętlą).
+inline thread_local int recursion_depth = 0;
+inline thread_local int max_recursion_depth = 0;
+
+template<bool Enabled>
+struct DepthGuard {
+};
+
+template<>
+struct DepthGuard<true> {
+    DepthGuard() {
+        if (++recursion_depth > max_recursion_depth) {
+            max_recursion_depth = recursion_depth;
+        }
+    }
+
+    ~DepthGuard() {
+        --recursion_depth;
+    }
+};
+
+#endif
@@ -0,0 +1,209 @@
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Timer.hpp"
+
+// Kolejka blokująca między etapami potoku; close() kończy pop() po opróżnieniu kolejki,
+// a push() po close() odrzuca element i zwraca false
+template<typename T>
+class BlockingQueue {
+public:
+    bool push(T value) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (closed) return false;
+            items.push_back(std::move(value));
+        }
+        ready.notify_one();
+        return true;
+    }
+
+    std::optional<T> pop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [this] { return !items.empty() || closed; });
+        if (items.empty()) return std::nullopt;
+        T value = std::move(items.front());
+        items.pop_front();
+        return value;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        ready.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<T> items;
+    bool closed{false};
+};
+
+// Czas pracy poszczególnych etapów w ms (sort - suma po wątkach sortujących)
+struct PipelineTimes {
+    int read;
+    int sort;
+    int merge;
+    int write;
+};
+
+// Potokowy tryb FILE: wątek czytający parsuje plik porcjami po chunk_size elementów,
+// workers wątków sortuje porcje zaraz po wczytaniu (sort(T *arr, int n)), a na końcu
+// scalanie k-drożne oddaje wynik blokami wątkowi zapisującemu, który pisze równolegle
+// ze scalaniem. Pusty output oznacza brak zapisu.
+template<typename T, typename Sort>
+PipelineTimes pipelined_sort_file(const std::string &input, const std::string &output, Sort sort,
+                                  int workers, int chunk_size = 1 << 16) {
+    std::ifstream in(input);
+    if (!in.is_open()) {
+        throw std::runtime_error("Cannot open file: " + input);
+    }
+    std::ofstream out;
+    if (!output.empty()) {
+        out.open(output);
+        if (!out.is_open()) {
+            throw std::runtime_error("Cannot open file for writing: " + output);
+        }
+    }
+
+    int size;
+    in >> size;
+    in.ignore();
+    if (workers < 1) workers = 1;
+
+    BlockingQueue<std::vector<T> > parsed;
+    BlockingQueue<std::vector<T> > merged;
+    std::vector<std::vector<T> > runs;
+    std::mutex runs_mutex;
+
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    const auto fail = [&] {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) error = std::current_exception();
+    };
+
+    Timer read_timer, merge_timer, write_timer;
+    std::vector<Timer> sort_timers(workers);
+
+    std::thread reader([&] {
+        try {
+            read_timer.start();
+            for (int done = 0; done < size;) {
+                int n = std::min(chunk_size, size - done);
+                std::vector<T> chunk(n);
+                for (int i = 0; i < n; ++i) {
+                    in >> chunk[i];
+                }
+                done += n;
+                read_timer.stop();
+                parsed.push(std::move(chunk));
+                read_timer.start();
+            }
+            read_timer.stop();
+        } catch (...) {
+            fail();
+        }
+        parsed.close();
+    });
+
+    std::vector<std::thread> sorters;
+    for (int w = 0; w < workers; ++w) {
+        sorters.emplace_back([&, w] {
+            try {
+                while (auto chunk = parsed.pop()) {
+                    sort_timers[w].start();
+                    sort(chunk->data(), static_cast<int>(chunk->size()));
+                    sort_timers[w].stop();
+
+                    std::lock_guard<std::mutex> lock(runs_mutex);
+                    runs.push_back(std::move(*chunk));
+                }
+            } catch (...) {
+                fail();
+            }
+        });
+    }
+
+    std::thread writer([&] {
+        try {
+            write_timer.start();
+            if (out.is_open()) out << size << '\n';
+            write_timer.stop();
+            while (auto block = merged.pop()) {
+                write_timer.start();
+                if (out.is_open()) {
+                    for (const T &value: *block) {
+                        out << value << '\n';
+                    }
+                }
+                write_timer.stop();
+            }
+        } catch (...) {
+            fail();
+        }
+    });
+
+    reader.join();
+    for (auto &sorter: sorters) {
+        sorter.join();
+    }
+
+    // Scalanie k-drożne: kopiec indeksów ciągów uporządkowany według bieżącego elementu
+    merge_timer.start();
+    if (!error) {
+        std::vector<size_t> heads(runs.size(), 0);
+        const auto later = [&](size_t a, size_t b) { return runs[a][heads[a]] > runs[b][heads[b]]; };
+        std::priority_queue<size_t, std::vector<size_t>, decltype(later)> heap(later);
+        for (size_t r = 0; r < runs.size(); ++r) {
+            if (!runs[r].empty()) heap.push(r);
+        }
+
+        const size_t block_size = static_cast<size_t>(chunk_size);
+        std::vector<T> block;
+        block.reserve(block_size);
+        while (!heap.empty()) {
+            size_t r = heap.top();
+            heap.pop();
+            block.push_back(std::move(runs[r][heads[r]]));
+            if (++heads[r] < runs[r].size()) heap.push(r);
+
+            if (block.size() == block_size) {
+                merge_timer.stop();
+                merged.push(std::move(block));
+                merge_timer.start();
+                block = std::vector<T>();
+                block.reserve(block_size);
+            }
+        }
+        if (!block.empty()) merged.push(std::move(block));
+    }
+    merge_timer.stop();
+    merged.close();
+    writer.join();
+
+    if (error) std::rethrow_exception(error);
+
+    PipelineTimes times{read_timer.result(), 0, merge_timer.result(), write_timer.result()};
+    for (const Timer &timer: sort_timers) {
+        times.sort += timer.result();
+    }
+    return times;
+}
+
+#endif
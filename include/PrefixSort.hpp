@@ -0,0 +1,68 @@
+#ifndef PREFIXSORT_HPP
+#define PREFIXSORT_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "Argsort.hpp"
+
+// Pierwsze 8 bajtów napisu jako liczba big-endian (krótsze dopełnione zerami), więc
+// porównanie liczb daje tę samą kolejność co memcmp w std::string::compare
+inline uint64_t string_prefix(const std::string &s) {
+    unsigned char bytes[8] = {};
+    std::memcpy(bytes, s.data(), s.size() < 8 ? s.size() : 8);
+
+    uint64_t prefix = 0;
+    for (unsigned char byte: bytes) {
+        prefix = prefix << 8 | byte;
+    }
+    return prefix;
+}
+
+// Klucz sortowania napisu: prefiks i długość trzymane obok indeksu, żeby większość porównań
+// rozstrzygała się bez sięgania do danych napisu. Przy równych prefiksach krótszy napis
+// (do 8 bajtów) jest mniejszy, a dane napisów są porównywane dopiero od 9. bajtu, gdy oba
+// są dłuższe. Tablica napisów jest wskazywana przez base, jak w ArgIndex.
+struct PrefixKey {
+    uint64_t prefix;
+    uint32_t length;
+    uint32_t index;
+
+    static inline thread_local const std::string *base = nullptr;
+
+    bool operator>(const PrefixKey &other) const {
+        if (prefix != other.prefix) return prefix > other.prefix;
+        if (length <= 8 || other.length <= 8) return length > other.length;
+        return base[index].compare(8, std::string::npos, base[other.index], 8, std::string::npos) > 0;
+    }
+
+    bool operator<=(const PrefixKey &other) const {
+        return !(*this > other);
+    }
+};
+
+// Sortuje napisy przez tablicę kluczy PrefixKey. sort(PrefixKey *keys, int n) to wybrany
+// algorytm; na koniec napisy są ustawiane w miejscu według kolejności kluczy.
+template<typename Sort>
+void prefix_sort(std::string *arr, int n, Sort sort) {
+    auto *keys = new PrefixKey[n];
+    for (int i = 0; i < n; ++i) {
+        keys[i] = {string_prefix(arr[i]), static_cast<uint32_t>(arr[i].size()), static_cast<uint32_t>(i)};
+    }
+
+    const std::string *previous_base = PrefixKey::base;
+    PrefixKey::base = arr;
+    sort(keys, n);
+    PrefixKey::base = previous_base;
+
+    auto *perm = new uint32_t[n];
+    for (int i = 0; i < n; ++i) {
+        perm[i] = keys[i].index;
+    }
+    delete[] keys;
+
+    apply_permutation(arr, perm, n);
+    delete[] perm;
+}
+
+#endif
@@ -0,0 +1,182 @@
+#ifndef SORTEDCONTAINER_HPP
+#define SORTEDCONTAINER_HPP
+
+#include <bit>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "SortingAlgorithms.hpp"
+
+// Kontener utrzymujący dane posortowane przy ciągłym dopisywaniu.
+// Nowe elementy trafiają do bufora; pełny bufor jest sortowany jednym z algorytmów
+// i scalany do poziomów jak w drzewie LSM: poziom i jest pusty albo trzyma jeden
+// posortowany ciąg ~batch_size * 2^i elementów. Wstawienie ciągu na zajęty poziom
+// scala oba i przenosi wynik poziom wyżej (jak przeniesienie w liczniku binarnym),
+// więc każdy element jest scalany O(log(n / batch_size)) razy - koszt zależy od
+// rozmiaru przyrostu, a nie od całego zbioru.
+template<typename T>
+class SortedContainer {
+public:
+    using SortFunction = std::function<void(T *arr, int n)>;
+
+    explicit SortedContainer(int batch_size = 1024,
+                             SortFunction sort_batch = [](T *arr, int n) { shell_sort(arr, n); })
+        : batch_size(batch_size > 0 ? batch_size : 1), sort_batch(std::move(sort_batch)), count(0) {
+        buffer.reserve(this->batch_size);
+    }
+
+    void insert(const T &value) {
+        buffer.push_back(value);
+        ++count;
+        if (static_cast<int>(buffer.size()) >= batch_size) {
+            flush();
+        }
+    }
+
+    void insert(const T *values, int n) {
+        for (int i = 0; i < n; ++i) {
+            insert(values[i]);
+        }
+    }
+
+    // Sortuje bufor i scala go do poziomów
+    void flush() {
+        if (buffer.empty()) return;
+
+        sort_batch(buffer.data(), static_cast<int>(buffer.size()));
+        std::vector<T> carry;
+        carry.swap(buffer);
+        buffer.reserve(batch_size);
+
+        for (auto &level: levels) {
+            if (level.empty()) {
+                level.swap(carry);
+                return;
+            }
+            // Starszy ciąg (z poziomu) idzie pierwszy - przy równych kluczach zachowuje kolejność wstawiania
+            merge_into(level, carry, scratch);
+            level.clear();
+            carry.swap(scratch);
+        }
+        levels.push_back(std::move(carry));
+    }
+
+    int size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    // Scala wszystkie poziomy w jeden ciąg i zwraca go (dostęp swobodny, begin()/end();
+    // referencja jest ważna do następnego insert()).
+    // Ciąg trafia na poziom ceil(log2(ceil(n / batch_size))), odpowiadający jego rozmiarowi,
+    // a niższe poziomy zostają puste - kolejne bufory scalają się najpierw między sobą
+    const std::vector<T> &sorted() {
+        flush();
+        std::vector<T> result;
+        for (auto &level: levels) {
+            if (level.empty()) continue;
+            if (result.empty()) {
+                result.swap(level);
+            } else {
+                merge_into(level, result, scratch);
+                level.clear();
+                result.swap(scratch);
+            }
+        }
+
+        size_t batches = (result.size() + batch_size - 1) / batch_size;
+        size_t target = batches > 1 ? std::bit_width(batches - 1) : 0;
+        levels.clear();
+        levels.resize(target + 1);
+        levels[target].swap(result);
+        return levels[target];
+    }
+
+    // Wywołuje f dla każdego elementu w kolejności rosnącej (scalanie k-drożne poziomów)
+    template<typename F>
+    void for_each(F f) {
+        flush();
+        std::vector<std::pair<int, int> > cursors;
+        for (int l = static_cast<int>(levels.size()) - 1; l >= 0; --l) {
+            if (!levels[l].empty()) cursors.emplace_back(l, 0);
+        }
+        visit_merged(cursors, nullptr, f);
+    }
+
+    // Wywołuje f dla elementów z przedziału [lo, hi] w kolejności rosnącej
+    template<typename F>
+    void range(const T &lo, const T &hi, F f) {
+        flush();
+        std::vector<std::pair<int, int> > cursors;
+        for (int l = static_cast<int>(levels.size()) - 1; l >= 0; --l) {
+            int first = lower_bound(levels[l], lo);
+            if (first < static_cast<int>(levels[l].size())) cursors.emplace_back(l, first);
+        }
+        visit_merged(cursors, &hi, f);
+    }
+
+private:
+    int batch_size;
+    SortFunction sort_batch;
+    int count;
+    std::vector<T> buffer;
+    std::vector<std::vector<T> > levels;
+    std::vector<T> scratch;
+
+    static void merge_into(const std::vector<T> &older, const std::vector<T> &newer, std::vector<T> &out) {
+        out.clear();
+        out.reserve(older.size() + newer.size());
+        size_t i = 0, j = 0;
+        while (i < older.size() && j < newer.size()) {
+            if (older[i] > newer[j]) {
+                out.push_back(newer[j++]);
+            } else {
+                out.push_back(older[i++]);
+            }
+        }
+        out.insert(out.end(), older.begin() + i, older.end());
+        out.insert(out.end(), newer.begin() + j, newer.end());
+    }
+
+    // Pierwszy indeks elementu >= value
+    static int lower_bound(const std::vector<T> &run, const T &value) {
+        int low = 0, high = static_cast<int>(run.size());
+        while (low < high) {
+            int mid = low + (high - low) / 2;
+            if (value > run[mid]) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return low;
+    }
+
+    // Kursory (poziom, pozycja) od najstarszego poziomu - przy remisie wygrywa starszy element.
+    // Poziomów jest O(log n), więc minimum wybieramy liniowo
+    template<typename F>
+    void visit_merged(std::vector<std::pair<int, int> > &cursors, const T *hi, F &f) const {
+        while (!cursors.empty()) {
+            size_t best = 0;
+            for (size_t c = 1; c < cursors.size(); ++c) {
+                const T &current = levels[cursors[c].first][cursors[c].second];
+                const T &smallest = levels[cursors[best].first][cursors[best].second];
+                if (smallest > current) best = c;
+            }
+
+            auto &[level, pos] = cursors[best];
+            const T &value = levels[level][pos];
+            if (hi && value > *hi) return;
+            f(value);
+
+            if (++pos == static_cast<int>(levels[level].size())) {
+                cursors.erase(cursors.begin() + best);
+            }
+        }
+    }
+};
+
+#endif
@@ -2,8 +2,11 @@
 #define SORTINGALGORITHMS_HPP
 
 #include <algorithm>
+#include <bit>
+#include <cstdint>
 #include <random>
 #include "Utilities.hpp"
+#include "MemoryStats.hpp"
 
 // Insertion Sort
 template<typename T>
@@ -20,8 +23,9 @@ void insertion_sort(T *arr, int n) {
 }
 
 // Heap Sort
-template<typename T>
+template<typename T, bool CountDepth = false>
 void heapify(T *arr, int n, int i) {
+    [[maybe_unused]] DepthGuard<CountDepth> guard;
     int largest = i;
     int left = 2 * i + 1;
     int right = 2 * i + 2;
@@ -34,18 +38,33 @@ void heapify(T *arr, int n, int i) {
 
     if (largest != i) {
         std::swap(arr[i], arr[largest]);
-        heapify(arr, n, largest);
+        heapify<T, CountDepth>(arr, n, largest);
     }
 }
 
-template<typename T>
+template<typename T, bool CountDepth = false>
 void heap_sort(T *arr, int n) {
     for (int i = n / 2 - 1; i >= 0; i--)
-        heapify(arr, n, i);
+        heapify<T, CountDepth>(arr, n, i);
 
     for (int i = n - 1; i > 0; i--) {
         std::swap(arr[0], arr[i]);
-        heapify(arr, i, 0);
+        heapify<T, CountDepth>(arr, i, 0);
+    }
+}
+
+// Partial Heap Sort - k największych elementów trafia posortowanych rosnąco
+// na koniec tablicy (arr[n - k .. n - 1]), reszta zostaje w kopcu. O(n + k log n)
+template<typename T, bool CountDepth = false>
+void partial_heap_sort(T *arr, int n, int k) {
+    if (k > n) k = n;
+
+    for (int i = n / 2 - 1; i >= 0; i--)
+        heapify<T, CountDepth>(arr, n, i);
+
+    for (int i = n - 1; i >= n - k && i > 0; i--) {
+        std::swap(arr[0], arr[i]);
+        heapify<T, CountDepth>(arr, i, 0);
     }
 }
 
@@ -134,59 +153,141 @@ int partition(T *arr, int low, int high, PivotType pt) {
     return i + 1;
 }
 
-template<typename T>
+template<typename T, bool CountDepth = false>
 void quick_sort(T *arr, int low, int high, PivotType pt) {
+    [[maybe_unused]] DepthGuard<CountDepth> guard;
     if (low < high) {
         int pi = partition(arr, low, high, pt);
-        quick_sort(arr, low, pi - 1, pt);
-        quick_sort(arr, pi + 1, high, pt);
+        quick_sort<T, CountDepth>(arr, low, pi - 1, pt);
+        quick_sort<T, CountDepth>(arr, pi + 1, high, pt);
+    }
+}
+
+// Quick Select (introselect) - ustawia na pozycji k element, który znalazłby się tam
+// po posortowaniu; na lewo od niego są elementy <=, na prawo >= (jak std::nth_element).
+// Gdy podziały są zbyt nierówne (ponad 2 log2 n), dokończenie przejmuje partial_heap_sort,
+// więc pesymistycznie O(n log n) zamiast O(n^2), średnio O(n).
+template<typename T, bool CountDepth = false>
+void quick_select(T *arr, int low, int high, int k, PivotType pt) {
+    int depth_limit = 2 * std::bit_width(static_cast<unsigned>(high - low + 1));
+
+    while (low < high) {
+        if (depth_limit-- == 0) {
+            int n = high - low + 1;
+            partial_heap_sort<T, CountDepth>(arr + low, n, n - (k - low));
+            return;
+        }
+
+        int pi = partition(arr, low, high, pt);
+        if (pi == k) return;
+        if (k < pi) {
+            high = pi - 1;
+        } else {
+            low = pi + 1;
+        }
     }
 }
 
 
 // Drunk Heap Sort
+
+// Generator xorshift64* z własnym stanem - każde wywołanie sortowania ma swój generator,
+// więc przebieg zależy tylko od danych i ziarna
+struct DrunkRandom {
+    uint64_t state;
+
+    explicit DrunkRandom(uint64_t seed) : state(seed ? seed : 0x9E3779B97F4A7C15ull) {
+    }
+
+    uint32_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return static_cast<uint32_t>((state * 0x2545F4914F6CDD1Dull) >> 32);
+    }
+
+    // Liczba z przedziału [0, bound)
+    uint32_t below(uint32_t bound) {
+        return static_cast<uint32_t>((static_cast<uint64_t>(next()) * bound) >> 32);
+    }
+};
+
 template<typename T>
-void drunk_heapify(T *arr, int n, int i, int drunkenness) {
-    int largest = i;
-    int left = 2 * i + 1;
-    int right = 2 * i + 2;
+void drunk_heapify(T *arr, int n, int i, int drunkenness, DrunkRandom &rng) {
+    while (true) {
+        int largest = i;
+        int left = 2 * i + 1;
+        int right = 2 * i + 2;
 
-    if (left < n && arr[left] > arr[largest])
-        largest = left;
-    if (right < n && arr[right] > arr[largest])
-        largest = right;
+        if (left < n && arr[left] > arr[largest])
+            largest = left;
+        if (right < n && arr[right] > arr[largest])
+            largest = right;
 
-    if (drunkenness > 0 && (rand() % 100 < drunkenness)) {
-        std::vector<int> options;
-        if (left < n) options.push_back(left);
-        if (right < n) options.push_back(right);
-        if (!options.empty()) {
-            int random_pick = options[rand() % options.size()];
-            largest = random_pick;
+        if (drunkenness > 0 && left < n && rng.below(100) < static_cast<uint32_t>(drunkenness)) {
+            largest = right < n && rng.below(2) ? right : left;
         }
-    }
 
-    if (largest != i) {
+        if (largest == i) return;
         std::swap(arr[i], arr[largest]);
-        drunk_heapify(arr, n, largest, drunkenness);
+        i = largest;
     }
 }
 
 template<typename T>
-void drunk_heap_sort(T *arr, int n, int drunkenness) {
+void drunk_heap_pass(T *arr, int n, int drunkenness, DrunkRandom &rng) {
     for (int i = n / 2 - 1; i >= 0; i--) {
-        drunk_heapify(arr, n, i, drunkenness);
+        drunk_heapify(arr, n, i, drunkenness, rng);
     }
 
     for (int i = n - 1; i > 0; i--) {
         std::swap(arr[0], arr[i]);
-        drunk_heapify(arr, i, 0, drunkenness);
+        drunk_heapify(arr, i, 0, drunkenness, rng);
     }
+}
 
-    // If not sorted, try again with reduced drunkenness
-    if (!is_sorted(arr, n)) {
-        drunk_heap_sort(arr, n, drunkenness / 2);
+// Najmniejsze okno [low, high], po którego posortowaniu cała tablica jest posortowana.
+// Elementy poza oknem są już na swoich miejscach. false, gdy tablica jest posortowana.
+template<typename T>
+bool unsorted_window(const T *arr, int n, int &low, int &high) {
+    int first = 0;
+    while (first < n - 1 && !(arr[first] > arr[first + 1])) ++first;
+    if (first >= n - 1) return false;
+
+    int last = n - 1;
+    while (last > 0 && !(arr[last - 1] > arr[last])) --last;
+
+    int min_idx = first, max_idx = first;
+    for (int i = first + 1; i <= last; ++i) {
+        if (arr[min_idx] > arr[i]) min_idx = i;
+        if (arr[i] > arr[max_idx]) max_idx = i;
+    }
+    while (first > 0 && arr[first - 1] > arr[min_idx]) --first;
+    while (last < n - 1 && arr[max_idx] > arr[last + 1]) ++last;
+
+    low = first;
+    high = last;
+    return true;
+}
+
+// Zwraca liczbę rund naprawy (0 albo 1). Po pijanym przebiegu naprawiane jest tylko okno
+// źle ułożonych elementów, jednym trzeźwym przebiegiem w miejscu: małe okna (do 32 elementów)
+// sortowaniem przez wstawianie, większe zwykłym Heap Sortem - O(n log n), bez bufora i bez alokacji.
+template<typename T>
+int drunk_heap_sort(T *arr, int n, int drunkenness, uint64_t seed = 1) {
+    DrunkRandom rng(seed);
+    drunk_heap_pass(arr, n, drunkenness, rng);
+
+    int low, high;
+    if (!unsorted_window(arr, n, low, high)) return 0;
+
+    int window = high - low + 1;
+    if (window <= 32) {
+        insertion_sort(arr + low, window);
+    } else {
+        heap_sort(arr + low, window);
     }
+    return 1;
 }
 
 #endif
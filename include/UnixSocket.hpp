@@ -0,0 +1,46 @@
+#ifndef UNIXSOCKET_HPP
+#define UNIXSOCKET_HPP
+
+#include <string>
+
+// Lokalne gniazdo AF_UNIX nasłuchujące na połączenia (tryb --batch --socket). Istniejąca ścieżka
+// jest zastępowana tylko, gdy jest nieużywanym gniazdem. SIGINT/SIGTERM kończą accept_client(),
+// więc destruktor zamyka gniazdo i usuwa jego plik
+class UnixServer {
+public:
+    explicit UnixServer(const std::string &path);
+
+    ~UnixServer();
+
+    UnixServer(const UnixServer &) = delete;
+
+    UnixServer &operator=(const UnixServer &) = delete;
+
+    // Deskryptor nowego połączenia albo -1 przy trwałym błędzie lub po SIGINT/SIGTERM
+    // (błędy przejściowe są ponawiane)
+    int accept_client();
+
+private:
+    std::string path;
+    int fd;
+};
+
+// Czyta kolejne linie z deskryptora (bez znaku '\n'); false po końcu danych
+class FdLineReader {
+public:
+    explicit FdLineReader(int fd);
+
+    bool next(std::string &line);
+
+private:
+    int fd;
+    std::string pending;
+    bool eof;
+};
+
+// Zapisuje cały napis, ponawiając częściowe zapisy; false gdy klient się rozłączył
+bool write_all(int fd, const std::string &data);
+
+void close_fd(int fd);
+
+#endif
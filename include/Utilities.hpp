@@ -9,7 +9,7 @@
 
 template<typename T>
 void generate_data(T *arr, int size) {
-    static std::mt19937 gen(std::random_device{}());
+    static thread_local std::mt19937 gen(std::random_device{}());
 
     if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
         std::uniform_int_distribution<T> dist(std::numeric_limits<T>::min(), std::numeric_limits<T>::max());
@@ -23,7 +23,7 @@ void generate_data(T *arr, int size) {
 template<>
 inline void generate_data<std::string>(std::string *arr, int size) {
     static const char charset[] = "abcdefghijklmnopqrstuvwxyz";
-    static std::mt19937 gen(std::random_device{}());
+    static thread_local std::mt19937 gen(std::random_device{}());
     std::uniform_int_distribution<int> len_dist(5, 20);
     std::uniform_int_distribution<int> char_dist(0, strlen(charset) - 1);
 
@@ -37,7 +37,7 @@ inline void generate_data<std::string>(std::string *arr, int size) {
 
 template<>
 inline void generate_data<BoardGame>(BoardGame *arr, int size) {
-    static std::mt19937 gen(std::random_device{}());
+    static thread_local std::mt19937 gen(std::random_device{}());
 
     std::uniform_int_distribution<int> min_players_dist(1, 6);
     std::uniform_int_distribution<int> max_offset_dist(0, 5);
@@ -79,10 +79,24 @@ inline void generate_data<BoardGame>(BoardGame *arr, int size) {
 
 template<typename T>
 bool is_sorted(const T *arr, int n) {
-    for (int i = 0; i < n - 1; ++i) {
-        if (arr[i] > arr[i + 1]) return false;
+    if constexpr (std::is_arithmetic_v<T>) {
+        // Bloki bez rozgałęzień w środku, żeby kompilator mógł zwektoryzować porównania
+        constexpr int block = 256;
+        for (int start = 0; start < n - 1; start += block) {
+            int end = std::min(start + block, n - 1);
+            int unsorted = 0;
+            for (int i = start; i < end; ++i) {
+                unsorted |= arr[i] > arr[i + 1];
+            }
+            if (unsorted) return false;
+        }
+        return true;
+    } else {
+        for (int i = 0; i < n - 1; ++i) {
+            if (arr[i] > arr[i + 1]) return false;
+        }
+        return true;
     }
-    return true;
 }
 
 #endif
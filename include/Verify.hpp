@@ -0,0 +1,134 @@
+#ifndef VERIFY_HPP
+#define VERIFY_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "BoardGame.hpp"
+#include "Utilities.hpp"
+
+// Weryfikacja wyniku sortowania (--verify): posortowanie sprawdzane równolegle oraz
+// niezależny od kolejności skrót multizbioru (suma skrótów elementów mod 2^64)
+// liczony przed i po sortowaniu - różne skróty oznaczają zgubiony lub zmieniony element.
+
+inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+template<typename T>
+uint64_t element_hash(const T &value) {
+    static_assert(std::is_arithmetic_v<T>, "element_hash needs an overload for this type");
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(T));
+    return mix64(bits);
+}
+
+inline uint64_t element_hash(const std::string &value) {
+    return mix64(std::hash<std::string_view>{}(value));
+}
+
+inline uint64_t element_hash(const BoardGame &bg) {
+    uint64_t h = element_hash(bg.title);
+    for (uint64_t part: {element_hash(bg.publisher), element_hash(bg.min_players), element_hash(bg.max_players),
+                         element_hash(bg.playtime), element_hash(bg.complexity), element_hash(bg.joy)}) {
+        h = mix64(h + part);
+    }
+    return h;
+}
+
+// Dzieli [begin, end) na części i wywołuje body(part_begin, part_end, part) w osobnych wątkach.
+// Małe zakresy są sprawdzane w bieżącym wątku - start wątku kosztowałby więcej niż praca.
+template<typename Body>
+void parallel_chunks(int begin, int end, int threads, Body body) {
+    constexpr int min_chunk = 1 << 16;
+    int n = end - begin;
+    int parts = std::max(1, std::min(threads, n / min_chunk));
+    if (parts == 1) {
+        body(begin, end, 0);
+        return;
+    }
+
+    std::vector<std::thread> pool;
+    for (int part = 0; part < parts; ++part) {
+        int part_begin = begin + static_cast<int>(static_cast<int64_t>(n) * part / parts);
+        int part_end = begin + static_cast<int>(static_cast<int64_t>(n) * (part + 1) / parts);
+        pool.emplace_back(body, part_begin, part_end, part);
+    }
+    for (auto &thread: pool) {
+        thread.join();
+    }
+}
+
+// Skrót multizbioru elementów arr (albo arr[perm[i]], gdy podano permutację)
+template<typename T>
+uint64_t multiset_hash(const T *arr, const uint32_t *perm, int n, int threads) {
+    std::vector<uint64_t> sums(std::max(threads, 1), 0);
+    parallel_chunks(0, n, threads, [&](int begin, int end, int part) {
+        uint64_t sum = 0;
+        for (int i = begin; i < end; ++i) {
+            sum += element_hash(perm ? arr[perm[i]] : arr[i]);
+        }
+        sums[part] = sum;
+    });
+
+    uint64_t total = mix64(static_cast<uint64_t>(n));
+    for (uint64_t sum: sums) {
+        total += sum;
+    }
+    return total;
+}
+
+// Czy arr[begin .. end - 1] (albo arr[perm[i]]) jest posortowane; części zachodzą na siebie o jeden element
+template<typename T>
+bool parallel_is_sorted(const T *arr, const uint32_t *perm, int begin, int end, int threads) {
+    if (end - begin < 2) return true;
+
+    std::vector<char> sorted(std::max(threads, 1), 1);
+    parallel_chunks(begin, end - 1, threads, [&](int part_begin, int part_end, int part) {
+        if (!perm) {
+            sorted[part] = is_sorted(arr + part_begin, part_end - part_begin + 1);
+            return;
+        }
+        for (int i = part_begin; i < part_end; ++i) {
+            if (arr[perm[i]] > arr[perm[i + 1]]) {
+                sorted[part] = 0;
+                return;
+            }
+        }
+    });
+
+    for (char ok: sorted) {
+        if (!ok) return false;
+    }
+    return true;
+}
+
+// Czy żaden z elementów arr[begin .. end - 1] nie jest większy niż bound (sprawdzenie podziału top-k)
+template<typename T>
+bool parallel_all_at_most(const T *arr, const uint32_t *perm, int begin, int end, const T &bound, int threads) {
+    std::vector<char> ok(std::max(threads, 1), 1);
+    parallel_chunks(begin, end, threads, [&](int part_begin, int part_end, int part) {
+        for (int i = part_begin; i < part_end; ++i) {
+            if ((perm ? arr[perm[i]] : arr[i]) > bound) {
+                ok[part] = 0;
+                return;
+            }
+        }
+    });
+
+    for (char part_ok: ok) {
+        if (!part_ok) return false;
+    }
+    return true;
+}
+
+#endif
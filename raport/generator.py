@@ -109,7 +109,7 @@ def run_algorithm(mode, algorithm, data_type, size=None, input_file=None, drunke
         print(
             f"{datetime.now()}{f' - Run index: {run_index}' if run_index is not None else ''} - Running command: {' '.join([str(arg) for arg in cmd])}")
         result = subprocess.run(cmd, capture_output=True, text=True, check=True)
-        return int(result.stdout.split("\n")[0].strip())
+        return int(result.stdout.split("\n")[0].split(",")[0].strip())
     except subprocess.CalledProcessError as e:
         print(f"Error running: {' '.join([str(arg) for arg in cmd])}")
         print(f"Error: {e.stderr}")
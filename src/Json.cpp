@@ -0,0 +1,125 @@
+#include "Json.hpp"
+#include <cctype>
+#include <stdexcept>
+
+namespace {
+    void skip_spaces(const std::string &line, size_t &pos) {
+        while (pos < line.size() && std::isspace(static_cast<unsigned char>(line[pos]))) ++pos;
+    }
+
+    void expect(const std::string &line, size_t &pos, char c) {
+        skip_spaces(line, pos);
+        if (pos >= line.size() || line[pos] != c) {
+            throw std::runtime_error(std::string("Invalid JSON: expected '") + c + "'");
+        }
+        ++pos;
+    }
+
+    std::string parse_string(const std::string &line, size_t &pos) {
+        expect(line, pos, '"');
+        std::string result;
+        while (pos < line.size() && line[pos] != '"') {
+            char c = line[pos++];
+            if (c == '\\') {
+                if (pos >= line.size()) break;
+                char escaped = line[pos++];
+                switch (escaped) {
+                    case 'n': result += '\n';
+                        break;
+                    case 't': result += '\t';
+                        break;
+                    case 'r': result += '\r';
+                        break;
+                    case 'b': result += '\b';
+                        break;
+                    case 'f': result += '\f';
+                        break;
+                    case 'u': {
+                        if (pos + 4 > line.size()) throw std::runtime_error("Invalid JSON: bad \\u escape");
+                        unsigned code = std::stoul(line.substr(pos, 4), nullptr, 16);
+                        pos += 4;
+                        if (code > 0x7f) throw std::runtime_error("Invalid JSON: only ASCII \\u escapes are supported");
+                        result += static_cast<char>(code);
+                        break;
+                    }
+                    default: result += escaped;
+                        break;
+                }
+            } else {
+                result += c;
+            }
+        }
+        expect(line, pos, '"');
+        return result;
+    }
+
+    // Liczba albo true/false/null - zwracana dosłownie
+    std::string parse_literal(const std::string &line, size_t &pos) {
+        size_t start = pos;
+        while (pos < line.size() && line[pos] != ',' && line[pos] != '}' &&
+               !std::isspace(static_cast<unsigned char>(line[pos]))) {
+            ++pos;
+        }
+        if (start == pos) throw std::runtime_error("Invalid JSON: missing value");
+        return line.substr(start, pos - start);
+    }
+}
+
+JsonObject parse_json_object(const std::string &line, JsonObject *raw) {
+    JsonObject object;
+    size_t pos = 0;
+    expect(line, pos, '{');
+    skip_spaces(line, pos);
+    if (pos < line.size() && line[pos] == '}') {
+        return object;
+    }
+
+    while (true) {
+        std::string key = parse_string(line, pos);
+        expect(line, pos, ':');
+        skip_spaces(line, pos);
+        if (pos < line.size() && (line[pos] == '{' || line[pos] == '[')) {
+            throw std::runtime_error("Invalid JSON: nested values are not supported (key \"" + key + "\")");
+        }
+        bool quoted = pos < line.size() && line[pos] == '"';
+        std::string &value = object[key];
+        value = quoted ? parse_string(line, pos) : parse_literal(line, pos);
+        if (raw) (*raw)[key] = quoted ? json_quote(value) : value;
+
+        skip_spaces(line, pos);
+        if (pos < line.size() && line[pos] == ',') {
+            ++pos;
+            continue;
+        }
+        expect(line, pos, '}');
+        return object;
+    }
+}
+
+std::string json_quote(const std::string &text) {
+    std::string result = "\"";
+    for (char c: text) {
+        switch (c) {
+            case '"': result += "\\\"";
+                break;
+            case '\\': result += "\\\\";
+                break;
+            case '\n': result += "\\n";
+                break;
+            case '\t': result += "\\t";
+                break;
+            case '\r': result += "\\r";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    const char *hex = "0123456789abcdef";
+                    result += "\\u00";
+                    result += hex[(c >> 4) & 0xf];
+                    result += hex[c & 0xf];
+                } else {
+                    result += c;
+                }
+        }
+    }
+    return result + "\"";
+}
@@ -0,0 +1,99 @@
+#include "Measurement.hpp"
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __linux__
+#include <sched.h>
+#include <malloc.h>
+#endif
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+namespace {
+    // Większy niż LLC typowych procesorów serwerowych
+    constexpr std::size_t flush_bytes = 256u << 20;
+    constexpr std::size_t line_bytes = 64;
+}
+
+const char *cache_mode_name(CacheMode mode) {
+    switch (mode) {
+        case CacheMode::COLD: return "cold";
+        case CacheMode::WARM: return "warm";
+        default: return "default";
+    }
+}
+
+bool pin_to_cpu(int cpu) {
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void) cpu;
+    return false;
+#endif
+}
+
+ScopedCpuPin::ScopedCpuPin(int cpu) : active(false) {
+#ifdef __linux__
+    if (cpu < 0 || sched_getaffinity(0, sizeof(saved), &saved) != 0) return;
+    active = pin_to_cpu(cpu);
+#else
+    (void) cpu;
+#endif
+}
+
+ScopedCpuPin::~ScopedCpuPin() {
+#ifdef __linux__
+    if (active) sched_setaffinity(0, sizeof(saved), &saved);
+#endif
+}
+
+bool ScopedCpuPin::pinned() const {
+    return active;
+}
+
+void touch_memory(void *data, std::size_t bytes, bool write) {
+    volatile unsigned char *bytes_ptr = static_cast<unsigned char *>(data);
+    unsigned char sink = 0;
+    for (std::size_t i = 0; i < bytes; i += line_bytes) {
+        if (write) {
+            bytes_ptr[i] = bytes_ptr[i];
+        } else {
+            sink ^= bytes_ptr[i];
+        }
+    }
+    (void) sink;
+}
+
+void flush_caches() {
+    // Bufor spoza malloc, żeby nie zostawał w stercie ani w RSS po pomiarze
+#ifndef _WIN32
+    void *buffer = mmap(nullptr, flush_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer == MAP_FAILED) return;
+    std::memset(buffer, 1, flush_bytes);
+    touch_memory(buffer, flush_bytes, false);
+    munmap(buffer, flush_bytes);
+#else
+    auto *buffer = static_cast<unsigned char *>(std::malloc(flush_bytes));
+    if (!buffer) return;
+    std::memset(buffer, 1, flush_bytes);
+    touch_memory(buffer, flush_bytes, false);
+    std::free(buffer);
+#endif
+}
+
+void prefault_heap(std::size_t scratch_bytes) {
+#if defined(__linux__) && defined(M_MMAP_MAX)
+    // Duże bloki z brk zamiast mmap i bez oddawania pamięci przy free()
+    mallopt(M_MMAP_MAX, 0);
+    mallopt(M_TRIM_THRESHOLD, -1);
+#endif
+    void *block = std::malloc(scratch_bytes);
+    if (!block) return;
+    std::memset(block, 0, scratch_bytes);
+    std::free(block);
+}
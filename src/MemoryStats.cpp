@@ -0,0 +1,131 @@
+#include "MemoryStats.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <string>
+#include <sys/resource.h>
+
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#elif defined(__linux__)
+#include <malloc.h>
+#endif
+
+namespace {
+    std::atomic<std::size_t> total_allocated{0};
+    std::atomic<std::size_t> live_bytes{0};
+    std::atomic<std::size_t> peak_live_bytes{0};
+
+    // Rzeczywisty rozmiar bloku - ten sam przy alokacji i zwolnieniu, więc live_bytes się bilansuje
+    std::size_t block_size(void *ptr, std::size_t requested) {
+#if defined(__APPLE__)
+        (void) requested;
+        return malloc_size(ptr);
+#elif defined(__linux__)
+        (void) requested;
+        return malloc_usable_size(ptr);
+#else
+        (void) ptr;
+        return requested;
+#endif
+    }
+
+    void record_alloc(std::size_t size) {
+        total_allocated.fetch_add(size, std::memory_order_relaxed);
+#if defined(__APPLE__) || defined(__linux__)
+        std::size_t live = live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+        std::size_t peak = peak_live_bytes.load(std::memory_order_relaxed);
+        while (live > peak && !peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+#endif
+    }
+
+    void record_free(std::size_t size) {
+        live_bytes.fetch_sub(size, std::memory_order_relaxed);
+    }
+
+    // Zeruje licznik VmHWM (Linux >= 4.0), żeby szczyt dotyczył tylko mierzonego obszaru
+    void reset_peak_rss() {
+#ifdef __linux__
+        std::ofstream clear_refs("/proc/self/clear_refs");
+        if (clear_refs.is_open()) {
+            clear_refs << "5";
+        }
+#endif
+    }
+
+    long read_peak_rss_kb() {
+#ifdef __linux__
+        std::ifstream status("/proc/self/status");
+        std::string key;
+        while (status >> key) {
+            if (key == "VmHWM:") {
+                long kb;
+                if (status >> kb) return kb;
+                break;
+            }
+            status.ignore(256, '\n');
+        }
+#endif
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+        return usage.ru_maxrss / 1024; // na macOS w bajtach
+#else
+        return usage.ru_maxrss;
+#endif
+    }
+}
+
+void *operator new(std::size_t size) {
+    void *ptr = std::malloc(size ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    record_alloc(block_size(ptr, size));
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+    if (ptr) {
+#if defined(__APPLE__) || defined(__linux__)
+        record_free(block_size(ptr, 0));
+#endif
+        std::free(ptr);
+    }
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+
+MemoryTracker::MemoryTracker() : allocated_at_start(0), live_at_start(0), stats{}, running(false) {
+}
+
+void MemoryTracker::start() {
+    if (!running) {
+        reset_peak_rss();
+        allocated_at_start = total_allocated.load(std::memory_order_relaxed);
+        live_at_start = live_bytes.load(std::memory_order_relaxed);
+        peak_live_bytes.store(live_at_start, std::memory_order_relaxed);
+        recursion_depth = 0;
+        max_recursion_depth = 0;
+        running = true;
+    }
+}
+
+void MemoryTracker::stop() {
+    if (running) {
+        stats.allocated_bytes = total_allocated.load(std::memory_order_relaxed) - allocated_at_start;
+        std::size_t peak = peak_live_bytes.load(std::memory_order_relaxed);
+        stats.peak_scratch_bytes = peak > live_at_start ? peak - live_at_start : 0;
+        stats.max_depth = max_recursion_depth;
+        stats.peak_rss_kb = read_peak_rss_kb();
+        running = false;
+    }
+}
+
+MemoryStats MemoryTracker::result() const {
+    return stats;
+}
@@ -0,0 +1,187 @@
+#include "UnixSocket.hpp"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#ifndef _WIN32
+#include <csignal>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#ifndef _WIN32
+
+namespace {
+    // Potok budzący accept_client() po SIGINT/SIGTERM; write() jest bezpieczne w obsłudze sygnału
+    int stop_pipe[2] = {-1, -1};
+
+    void request_stop(int) {
+        char byte = 1;
+        ssize_t ignored = write(stop_pipe[1], &byte, 1);
+        (void) ignored;
+    }
+
+    void install_stop_handler() {
+        if (stop_pipe[0] < 0 && pipe(stop_pipe) < 0) {
+            throw std::runtime_error("Cannot create stop pipe: " + std::string(std::strerror(errno)));
+        }
+        struct sigaction action{};
+        action.sa_handler = request_stop;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGINT, &action, nullptr);
+        sigaction(SIGTERM, &action, nullptr);
+    }
+
+    // Istniejąca ścieżka może zostać zastąpiona tylko, gdy jest nieużywanym gniazdem
+    void remove_stale_socket(const std::string &path, const sockaddr_un &address) {
+        struct stat info{};
+        if (lstat(path.c_str(), &info) < 0) return;
+        if (!S_ISSOCK(info.st_mode)) {
+            throw std::runtime_error("Refusing to replace non-socket file: " + path);
+        }
+        int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (probe >= 0) {
+            bool in_use = connect(probe, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0;
+            ::close(probe);
+            if (in_use) {
+                throw std::runtime_error("Socket already in use: " + path);
+            }
+        }
+        unlink(path.c_str());
+    }
+}
+
+UnixServer::UnixServer(const std::string &path) : path(path), fd(-1) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Socket path too long: " + path);
+    }
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+    remove_stale_socket(path, address);
+    install_stop_handler();
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot create socket: " + std::string(std::strerror(errno)));
+    }
+    // Rozłączony klient ma kończyć się błędem zapisu, a nie SIGPIPE
+    std::signal(SIGPIPE, SIG_IGN);
+    if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 || listen(fd, 16) < 0) {
+        std::string reason = std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error("Cannot listen on " + path + ": " + reason);
+    }
+}
+
+UnixServer::~UnixServer() {
+    ::close(fd);
+    unlink(path.c_str());
+}
+
+int UnixServer::accept_client() {
+    while (true) {
+        pollfd watched[2] = {{fd, POLLIN, 0}, {stop_pipe[0], POLLIN, 0}};
+        if (poll(watched, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (watched[1].revents) return -1;
+        if (!(watched[0].revents & POLLIN)) continue;
+
+        int client = accept(fd, nullptr, nullptr);
+        if (client >= 0) return client;
+        switch (errno) {
+            case EINTR:
+            case ECONNABORTED:
+            case EPROTO:
+                continue;
+            // Brak deskryptorów lub pamięci mija, gdy inni klienci się rozłączą
+            case EMFILE:
+            case ENFILE:
+            case ENOBUFS:
+            case ENOMEM:
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                continue;
+            default:
+                return -1;
+        }
+    }
+}
+
+FdLineReader::FdLineReader(int fd) : fd(fd), eof(false) {
+}
+
+bool FdLineReader::next(std::string &line) {
+    while (true) {
+        size_t newline = pending.find('\n');
+        if (newline != std::string::npos) {
+            line = pending.substr(0, newline);
+            pending.erase(0, newline + 1);
+            return true;
+        }
+        if (eof) {
+            if (pending.empty()) return false;
+            line.swap(pending);
+            pending.clear();
+            return true;
+        }
+
+        char buffer[4096];
+        ssize_t count = read(fd, buffer, sizeof(buffer));
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) {
+            eof = true;
+        } else {
+            pending.append(buffer, static_cast<size_t>(count));
+        }
+    }
+}
+
+bool write_all(int fd, const std::string &data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t count = write(fd, data.data() + written, data.size() - written);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) return false;
+        written += static_cast<size_t>(count);
+    }
+    return true;
+}
+
+void close_fd(int fd) {
+    ::close(fd);
+}
+
+#else
+
+UnixServer::UnixServer(const std::string &path) : path(path), fd(-1) {
+    throw std::runtime_error("Unix sockets are not supported on this platform");
+}
+
+UnixServer::~UnixServer() = default;
+
+int UnixServer::accept_client() {
+    return -1;
+}
+
+FdLineReader::FdLineReader(int fd) : fd(fd), eof(true) {
+}
+
+bool FdLineReader::next(std::string &) {
+    return false;
+}
+
+bool write_all(int, const std::string &) {
+    return false;
+}
+
+void close_fd(int) {
+}
+
+#endif
@@ -1,13 +1,46 @@
+#include <atomic>
+#include <cstdio>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 #include "Timer.hpp"
+#include "MemoryStats.hpp"
+#include "Measurement.hpp"
 #include "BoardGame.hpp"
 #include "SortingAlgorithms.hpp"
 #include "Utilities.hpp"
 #include "FileIO.hpp"
+#include "Argsort.hpp"
+#include "PrefixSort.hpp"
+#include "SortedContainer.hpp"
+#include "Pipeline.hpp"
+#include "Verify.hpp"
+#include "Json.hpp"
+#include "UnixSocket.hpp"
 
 using namespace std;
 
+// Mapowanie algorytmów
+enum AlgorithmType {
+    INSERTION,
+    HEAP,
+    SHELL,
+    QUICK,
+    DRUNK_QUICK
+};
+
+// Mapowanie typów danych
+enum DataType {
+    INT,
+    FLOAT,
+    STRING,
+    BOARDGAME
+};
+
 // Funkcja pomocnicza do parsowania argumentów
 struct ProgramParams {
     string mode;
@@ -17,6 +50,17 @@ struct ProgramParams {
     string outputFile;
     int drunkenness{50};
     int size{};
+    bool stats{false};
+    int top{0};
+    bool argsort{false};
+    bool prefix{false};
+    bool pipeline{false};
+    int workers{0};
+    string socketPath;
+    MeasurementSettings measurement;
+    uint64_t seed{1};
+    bool verify{false};
+    int stream{0};
 };
 
 ProgramParams parseArguments(int argc, char *argv[]) {
@@ -26,7 +70,114 @@ ProgramParams parseArguments(int argc, char *argv[]) {
         return params;
     }
 
-    string arg1 = argv[1];
+    // Opcje "--nazwa" podane po trybie działania są usuwane przed parsowaniem argumentów pozycyjnych
+    vector<string> args;
+    for (int i = 0; i < argc; ++i) {
+        string arg = argv[i];
+        if (i > 1 && arg == "--stats") {
+            params.stats = true;
+            continue;
+        }
+        if (i > 1 && arg == "--argsort") {
+            params.argsort = true;
+            continue;
+        }
+        if (i > 1 && arg == "--prefix") {
+            params.prefix = true;
+            continue;
+        }
+        if (i > 1 && arg == "--pipeline") {
+            params.pipeline = true;
+            continue;
+        }
+        if (i > 1 && arg == "--workers") {
+            try {
+                params.workers = i + 1 < argc ? stoi(argv[++i]) : 0;
+            } catch (const logic_error &e) {
+            }
+            if (params.workers <= 0) {
+                cerr << "--workers wymaga dodatniej liczby całkowitej." << endl;
+                params.mode = "help";
+                return params;
+            }
+            continue;
+        }
+        if (i > 1 && arg == "--socket") {
+            params.socketPath = i + 1 < argc ? argv[++i] : "";
+            if (params.socketPath.empty()) {
+                cerr << "--socket wymaga ścieżki gniazda." << endl;
+                params.mode = "help";
+                return params;
+            }
+            continue;
+        }
+        if (i > 1 && (arg == "--cold" || arg == "--warm")) {
+            params.measurement.cache = arg == "--cold" ? CacheMode::COLD : CacheMode::WARM;
+            params.stats = true;
+            continue;
+        }
+        if (i > 1 && arg == "--prefault") {
+            params.measurement.prefault = true;
+            params.stats = true;
+            continue;
+        }
+        if (i > 1 && arg == "--pin") {
+            try {
+                params.measurement.cpu = i + 1 < argc ? stoi(argv[++i]) : -1;
+            } catch (const logic_error &e) {
+                params.measurement.cpu = -1;
+            }
+            if (params.measurement.cpu < 0) {
+                cerr << "--pin wymaga numeru rdzenia." << endl;
+                params.mode = "help";
+                return params;
+            }
+            params.stats = true;
+            continue;
+        }
+        if (i > 1 && arg == "--seed") {
+            try {
+                params.seed = i + 1 < argc ? stoull(argv[++i]) : 0;
+            } catch (const logic_error &e) {
+                cerr << "--seed wymaga nieujemnej liczby całkowitej." << endl;
+                params.mode = "help";
+                return params;
+            }
+            continue;
+        }
+        if (i > 1 && arg == "--verify") {
+            params.verify = true;
+            continue;
+        }
+        if (i > 1 && arg == "--stream") {
+            try {
+                params.stream = i + 1 < argc ? stoi(argv[++i]) : 0;
+            } catch (const logic_error &e) {
+            }
+            if (params.stream <= 0) {
+                cerr << "--stream wymaga dodatniego rozmiaru partii." << endl;
+                params.mode = "help";
+                return params;
+            }
+            continue;
+        }
+        if (i > 1 && arg == "--top") {
+            try {
+                params.top = i + 1 < argc ? stoi(argv[++i]) : 0;
+            } catch (const logic_error &e) {
+            }
+            if (params.top <= 0) {
+                cerr << "--top wymaga dodatniej liczby całkowitej." << endl;
+                params.mode = "help";
+                return params;
+            }
+            continue;
+        }
+        args.push_back(arg);
+    }
+    argc = static_cast<int>(args.size());
+
+    string arg1 = args[1];
     if (arg1 == "--help") {
         params.mode = "help";
         return params;
@@ -38,20 +189,20 @@ ProgramParams parseArguments(int argc, char *argv[]) {
             return params;
         }
         params.mode = "file";
-        params.algorithm = argv[2];
-        params.type = argv[3];
-        params.inputFile = argv[4];
+        params.algorithm = args[2];
+        params.type = args[3];
+        params.inputFile = args[4];
         if (argc == 6) {
             try {
-                params.drunkenness = stoi(argv[5]);
+                params.drunkenness = stoi(args[5]);
             } catch (const invalid_argument &e) {
-                params.outputFile = argv[5];
+                params.outputFile = args[5];
             }
         }
         if (argc == 7) {
-            params.outputFile = argv[5];
+            params.outputFile = args[5];
             try {
-                params.drunkenness = stoi(argv[6]);
+                params.drunkenness = stoi(args[6]);
             } catch (const invalid_argument &e) {
                 cerr << "Drunkenness must be an integer." << endl;
                 params.mode = "help";
@@ -65,10 +216,10 @@ ProgramParams parseArguments(int argc, char *argv[]) {
             return params;
         }
         params.mode = "test";
-        params.algorithm = argv[2];
-        params.type = argv[3];
+        params.algorithm = args[2];
+        params.type = args[3];
         try {
-            params.size = stoi(argv[4]);
+            params.size = stoi(args[4]);
         } catch (const invalid_argument &e) {
             cerr << "Rozmiar musi być liczbą całkowitą." << endl;
             params.mode = "help";
@@ -76,13 +227,20 @@ ProgramParams parseArguments(int argc, char *argv[]) {
         }
         if (argc == 6) {
             try {
-                params.drunkenness = stoi(argv[5]);
+                params.drunkenness = stoi(args[5]);
             } catch (const invalid_argument &e) {
                 cerr << "Drunkenness must be an integer." << endl;
                 params.mode = "help";
                 return params;
             }
         }
+    } else if (arg1 == "--batch") {
+        if (argc != 2) {
+            cerr << "Nieprawidłowa liczba argumentów dla trybu --batch." << endl;
+            params.mode = "help";
+            return params;
+        }
+        params.mode = "batch";
     } else {
         cerr << "Nieznany tryb działania." << endl;
         params.mode = "help";
@@ -91,7 +249,6 @@ ProgramParams parseArguments(int argc, char *argv[]) {
 
     return params;
 }
-
 // Funkcja do wyświetlania pomocy
 void showHelp() {
     cout << "FILE TEST MODE:" << endl;
@@ -115,6 +272,49 @@ void showHelp() {
     cout << "    [drunkenness] Optional parameter for Drunk Heap Sort (default: 50)." << endl;
     cout << "    [pivot type] Optional parameter for Quick Sort: 0 - Left, 1 - Right, 2 - Middle, 3 - Random (default)."
             << endl;
+    cout << "OPTIONS (may follow --file or --test):" << endl;
+    cout << "    --stats Append memory columns and the measurement settings to the result line:" << endl;
+    cout << "            time_ms,peak_rss_kb,alloc_bytes,peak_scratch_bytes,max_depth,cpu,cache,prefault,repair_rounds" << endl;
+    cout << "            (repair_rounds - 1 when Drunk Heap Sort had to repair its out-of-order window, else 0)." << endl;
+    cout << "    --verify Check the result: a parallel sortedness scan plus an order-independent multiset hash" << endl;
+    cout << "            computed before and after the sort. Prints \"verify: ok\" (or the failure) to stderr;" << endl;
+    cout << "            a failed check exits with code 2 and --file writes no output file. Not available with --pipeline." << endl;
+    cout << "    --seed <N> Seed of the Drunk Heap Sort random generator (default: 1)." << endl;
+    cout << "    --pin <CPU> Pin the sorting thread to the given core for the timed region only" << endl;
+    cout << "            (sched_setaffinity, Linux only). Not available with --pipeline." << endl;
+    cout << "    --cold / --warm Flush the caches by sweeping a 256 MiB buffer / read the whole array" << endl;
+    cout << "            right before the timed region." << endl;
+    cout << "    --prefault Touch the array pages and pre-grow the heap for scratch allocations, so first-touch" << endl;
+    cout << "            page faults are not timed. Changes malloc settings (no heap trimming, no mmap) until exit." << endl;
+    cout << "            --pin, --cold, --warm and --prefault imply --stats; --cold, --warm and --prefault are not" << endl;
+    cout << "            available with --pipeline (its data is read inside the timed region)." << endl;
+    cout << "    --top <K> Select only the K largest elements (quickselect + <algorithm> on them," << endl;
+    cout << "            heap-based partial sort for Heap Sort). In --file mode only those K are saved, ascending." << endl;
+    cout << "    --argsort Sort a uint32_t index array instead of moving records. --file writes the records" << endl;
+    cout << "            through the permutation, --test applies it in place by following its cycles (timed)." << endl;
+    cout << "    --prefix For strings: sort keys holding the first 8 bytes as a big-endian integer and" << endl;
+    cout << "            compare the full strings only when those prefixes are equal." << endl;
+    cout << "    --pipeline For --file: parse, sort and write concurrently - chunks are sorted as they are read," << endl;
+    cout << "            then k-way merged while being written. Prints the total time, then per-stage times." << endl;
+    cout << "    --workers <N> Number of sorting threads for --pipeline (default: hardware threads)." << endl;
+    cout << "    --stream <B> Insert the records one by one into a SortedContainer (batches of B sorted with" << endl;
+    cout << "            <algorithm>, merged in LSM levels) and read them back in order (timed). With --verify" << endl;
+    cout << "            a range query over the middle half is also compared with the result." << endl;
+    cout << "BATCH MODE:" << endl;
+    cout << "    Usage:" << endl;
+    cout << "        ./aizo1 --batch [--socket <path>] [--workers <N>]" << endl;
+    cout << "    Reads one job per line as a flat JSON object from stdin (or from clients of a Unix socket)" << endl;
+    cout << "    and runs the jobs on a pool of N threads that reuse their data buffers. Keys: algorithm, type," << endl;
+    cout << "    input, output, size, param (drunkenness/pivot type), mode (file/test), top, argsort, prefix," << endl;
+    cout << "    pipeline, stream, pin, cache (cold/warm), seed, verify, id. Jobs with \"input\" default to file mode, others to test mode." << endl;
+    cout << "    prefault is rejected: it changes allocator settings for the whole, long-running process." << endl;
+    cout << "    --socket replaces only a stale socket file; SIGINT/SIGTERM stop accepting clients, finish queued" << endl;
+    cout << "    jobs and remove the socket file." << endl;
+    cout << "    Each finished job is answered with one JSON line: id, status, time_ms and memory columns." << endl;
+    cout << "    Results come back in completion order; id echoes the job's \"id\" (same JSON type) or, without" << endl;
+    cout << "    one, the job's line number on that client (1-based)." << endl;
+    cout << "    With several workers peak_rss_kb, alloc_bytes and peak_scratch_bytes are null - they are" << endl;
+    cout << "    process-wide and would mix concurrent jobs; max_depth is tracked per thread and stays valid." << endl;
     cout << "HELP MODE:" << endl;
     cout << "    Usage:" << endl;
     cout << "        ./aizo1 --help" << endl;
@@ -131,31 +331,371 @@ void showHelp() {
             << endl;
 }
 
-int main(int argc, char *argv[]) {
-    ProgramParams params = parseArguments(argc, argv);
 
-    if (params.mode == "help") {
-        showHelp();
+// Wybór algorytmu sortowania; zwraca liczbę rund naprawy Drunk Heap Sort (0 dla pozostałych).
+// CountDepth wybiera instancje algorytmów rekurencyjnych zliczające głębokość (tylko dla --stats)
+template<typename T, bool CountDepth>
+int sort_array(T *arr, int size, AlgorithmType algorithmType, PivotType pivotType, int drunkenness, uint64_t seed) {
+    switch (algorithmType) {
+        case INSERTION:
+            insertion_sort(arr, size);
+            break;
+        case HEAP:
+            heap_sort<T, CountDepth>(arr, size);
+            break;
+        case SHELL:
+            shell_sort(arr, size);
+            break;
+        case QUICK:
+            quick_sort<T, CountDepth>(arr, 0, size - 1, pivotType);
+            break;
+        case DRUNK_QUICK:
+            return drunk_heap_sort(arr, size, drunkenness, seed);
+    }
+    return 0;
+}
+
+// Zapytanie top-k: k największych elementów ląduje posortowanych w arr[size - k .. size - 1]
+template<typename T, bool CountDepth>
+int select_top(T *arr, int size, int k, AlgorithmType algorithmType, PivotType pivotType, int drunkenness,
+               uint64_t seed) {
+    if (k > size) k = size;
+    if (algorithmType == HEAP) {
+        partial_heap_sort<T, CountDepth>(arr, size, k);
         return 0;
     }
+    if (k < size) {
+        quick_select<T, CountDepth>(arr, 0, size - 1, size - k, pivotType);
+    }
+    return sort_array<T, CountDepth>(arr + size - k, k, algorithmType, pivotType, drunkenness, seed);
+}
 
-    // Mapowanie algorytmów
-    enum AlgorithmType {
-        INSERTION,
-        HEAP,
-        SHELL,
-        QUICK,
-        DRUNK_QUICK
-    };
+// Pełne sortowanie albo zapytanie top-k, zależnie od --top
+template<typename T>
+int run_sort(T *arr, int size, const ProgramParams &params, AlgorithmType algorithmType, PivotType pivotType) {
+    if constexpr (is_same_v<T, string>) {
+        if (params.prefix) {
+            int rounds = 0;
+            prefix_sort(arr, size, [&](PrefixKey *keys, int n) {
+                rounds = run_sort(keys, n, params, algorithmType, pivotType);
+            });
+            return rounds;
+        }
+    }
+    if (params.top > 0) {
+        return params.stats
+                   ? select_top<T, true>(arr, size, params.top, algorithmType, pivotType, params.drunkenness, params.seed)
+                   : select_top<T, false>(arr, size, params.top, algorithmType, pivotType, params.drunkenness, params.seed);
+    }
+    return params.stats
+               ? sort_array<T, true>(arr, size, algorithmType, pivotType, params.drunkenness, params.seed)
+               : sort_array<T, false>(arr, size, algorithmType, pivotType, params.drunkenness, params.seed);
+}
+
+// Sortowanie przez SortedContainer (--stream): rekordy są wstawiane pojedynczo jak z napływającego
+// strumienia, partie sortuje wybrany algorytm, a wynik wraca do arr przez for_each. Kontener jest
+// zwracany, żeby --verify mógł sprawdzić na nim range(); rounds - największa liczba rund naprawy partii
+template<typename T>
+unique_ptr<SortedContainer<T> > run_stream(T *arr, int size, const ProgramParams &params,
+                                           AlgorithmType algorithmType, PivotType pivotType, int &rounds) {
+    rounds = 0;
+    auto container = make_unique<SortedContainer<T> >(params.stream, [&params, algorithmType, pivotType, &rounds](
+                                                          T *batch, int n) {
+        rounds = max(rounds, run_sort(batch, n, params, algorithmType, pivotType));
+    });
+    for (int i = 0; i < size; ++i) {
+        container->insert(arr[i]);
+    }
+    int next = 0;
+    container->for_each([&](const T &value) { arr[next++] = value; });
+    return container;
+}
+
+// Sortowanie indeksów zamiast rekordów (--argsort)
+template<typename T>
+uint32_t *run_argsort(const T *arr, int size, const ProgramParams &params, AlgorithmType algorithmType,
+                      PivotType pivotType, int &rounds) {
+    return argsort(arr, size, [&](ArgIndex<T> *idx, int n) {
+        rounds = run_sort(idx, n, params, algorithmType, pivotType);
+    });
+}
 
-    // Mapowanie typów danych
-    enum DataType {
-        INT,
-        FLOAT,
-        STRING,
-        BOARDGAME
+// Wynik jednego przebiegu sortowania
+struct RunResult {
+    int time_ms{};
+    MemoryStats memory{};
+    bool pipelined{false};
+    int workers{};
+    PipelineTimes stages{};
+    MeasurementSettings settings{};
+    int repair_rounds{};
+    string verify;               // "" - bez weryfikacji, "ok", "unsorted", "multiset_mismatch", "range_mismatch"
+    int verify_ms{};
+};
+
+// Bufory danych używane ponownie przez kolejne zadania jednego wątku (--batch)
+struct JobBuffers {
+    vector<int> ints;
+    vector<float> floats;
+    vector<string> strings;
+    vector<BoardGame> boardGames;
+
+    template<typename T>
+    vector<T> &get() {
+        if constexpr (is_same_v<T, int>) return ints;
+        else if constexpr (is_same_v<T, float>) return floats;
+        else if constexpr (is_same_v<T, string>) return strings;
+        else return boardGames;
+    }
+};
+
+void print_result(const RunResult &result, const ProgramParams &params) {
+    cout << result.time_ms;
+    if (params.stats) {
+        cout << ',' << result.memory.peak_rss_kb
+                << ',' << result.memory.allocated_bytes
+                << ',' << result.memory.peak_scratch_bytes
+                << ',' << result.memory.max_depth
+                << ',' << result.settings.cpu
+                << ',' << cache_mode_name(result.settings.cache)
+                << ',' << result.settings.prefault
+                << ',' << result.repair_rounds;
+    }
+    cout << endl;
+    if (result.pipelined) {
+        cout << "read " << result.stages.read << " ms, sort " << result.stages.sort << " ms (" << result.workers
+                << " workers), merge " << result.stages.merge << " ms, write " << result.stages.write << " ms" << endl;
+    }
+}
+
+int verifyThreads(const ProgramParams &params) {
+    return max(params.workers > 0 ? params.workers : static_cast<int>(thread::hardware_concurrency()), 1);
+}
+
+// Zapytanie range() o środkową połowę wyniku musi zwrócić dokładnie ten sam fragment arr (--stream)
+template<typename T>
+bool stream_range_matches(SortedContainer<T> &container, const T *arr, int size) {
+    if (size == 0) return true;
+    const T &lo = arr[size / 4];
+    const T &hi = arr[size - 1 - size / 4];
+    int next = 0;
+    while (lo > arr[next]) ++next;
+
+    bool matches = true;
+    container.range(lo, hi, [&](const T &value) {
+        matches = matches && next < size && element_hash(value) == element_hash(arr[next]);
+        ++next;
+    });
+    return matches && (next == size || arr[next] > hi);
+}
+
+// Weryfikacja wyniku (--verify): posortowanie (dla --top także podział na k największych) i skrót multizbioru;
+// dla --stream także zapytanie range() na kontenerze
+template<typename T>
+void verify_result(const T *arr, const uint32_t *perm, int size, uint64_t input_hash, const ProgramParams &params,
+                   Timer &timer, RunResult &result, SortedContainer<T> *stream = nullptr) {
+    int threads = verifyThreads(params);
+    timer.start();
+
+    int first = params.top > 0 ? size - min(params.top, size) : 0;
+    bool sorted = parallel_is_sorted(arr, perm, first, size, threads);
+    if (sorted && first > 0) {
+        sorted = parallel_all_at_most(arr, perm, 0, first, perm ? arr[perm[first]] : arr[first], threads);
+    }
+
+    if (!sorted) {
+        result.verify = "unsorted";
+    } else if (multiset_hash(arr, perm, size, threads) != input_hash) {
+        result.verify = "multiset_mismatch";
+    } else if (stream && !stream_range_matches(*stream, arr, size)) {
+        result.verify = "range_mismatch";
+    } else {
+        result.verify = "ok";
+    }
+
+    timer.stop();
+    result.verify_ms = timer.result();
+}
+
+// Ustawienia pomiaru zapisywane w wyniku; rdzeń tylko wtedy, gdy przypięcie się udało.
+// Przypięty jest wyłącznie mierzony obszar - wątki startowane później (np. weryfikacja) dziedziczyłyby
+// maskę jednego rdzenia
+MeasurementSettings applied_settings(const ProgramParams &params, bool pinned) {
+    MeasurementSettings settings = params.measurement;
+    if (settings.cpu >= 0 && !pinned) {
+        cerr << "Nie udało się przypiąć wątku do rdzenia " << settings.cpu << "." << endl;
+        settings.cpu = -1;
+    }
+    return settings;
+}
+
+// Tryb FILE z --pipeline; mierzony jest cały czas od otwarcia wejścia do zamknięcia wyjścia
+template<typename T>
+RunResult run_pipeline(const ProgramParams &params, AlgorithmType algorithmType, PivotType pivotType) {
+    RunResult result;
+    result.pipelined = true;
+    result.workers = max(params.workers > 0 ? params.workers : static_cast<int>(thread::hardware_concurrency()), 1);
+
+    // Porcje sortują osobne wątki z własnymi (thread_local) licznikami głębokości - zbierane jest maksimum,
+    // tak samo jak największa liczba rund naprawy po porcjach
+    atomic<int> maxDepth{0};
+    atomic<int> maxRounds{0};
+    const auto raise = [](atomic<int> &target, int value) {
+        int seen = target.load();
+        while (value > seen && !target.compare_exchange_weak(seen, value)) {
+        }
     };
 
+    Timer timer;
+    MemoryTracker memory;
+    memory.start();
+    timer.start();
+    result.stages = pipelined_sort_file<T>(params.inputFile, params.outputFile, [&](T *arr, int n) {
+        raise(maxRounds, run_sort(arr, n, params, algorithmType, pivotType));
+        raise(maxDepth, max_recursion_depth);
+    }, result.workers);
+    timer.stop();
+    memory.stop();
+
+    result.time_ms = timer.result();
+    result.memory = memory.result();
+    result.memory.max_depth = maxDepth;
+    result.repair_rounds = maxRounds;
+    result.settings = applied_settings(params, false);
+    return result;
+}
+
+// Tryb FILE
+template<typename T>
+RunResult run_file(const ProgramParams &params, AlgorithmType algorithmType, PivotType pivotType,
+                   vector<T> &buffer) {
+    if (params.pipeline) {
+        return run_pipeline<T>(params, algorithmType, pivotType);
+    }
+
+    load_data(params.inputFile, buffer);
+    T *arr = buffer.data();
+    int size = static_cast<int>(buffer.size());
+    Timer verifyTimer;
+    uint64_t inputHash = 0;
+    if (params.verify) {
+        verifyTimer.start();
+        inputHash = multiset_hash(arr, nullptr, size, verifyThreads(params));
+        verifyTimer.stop();
+    }
+
+    Timer timer;
+    MemoryTracker memory;
+    uint32_t *perm = nullptr;
+    unique_ptr<SortedContainer<T> > stream;
+    int rounds;
+    bool pinned;
+    {
+        ScopedCpuPin pin(params.measurement.cpu);
+        pinned = pin.pinned();
+        prepare_measurement(params.measurement, arr, size);
+
+        memory.start();
+        timer.start();
+        if (params.argsort) {
+            perm = run_argsort(arr, size, params, algorithmType, pivotType, rounds);
+        } else if (params.stream > 0) {
+            stream = run_stream(arr, size, params, algorithmType, pivotType, rounds);
+        } else {
+            rounds = run_sort(arr, size, params, algorithmType, pivotType);
+        }
+        timer.stop();
+        memory.stop();
+    }
+
+    RunResult result;
+    result.time_ms = timer.result();
+    result.memory = memory.result();
+    result.settings = applied_settings(params, pinned);
+    result.repair_rounds = rounds;
+    if (params.verify) {
+        verify_result(arr, perm, size, inputHash, params, verifyTimer, result, stream.get());
+    }
+
+    // Zapis do pliku wyjściowego (jeśli podano). Wynik, który nie przeszedł --verify, nie jest zapisywany,
+    // a plik z wcześniejszego uruchomienia jest usuwany, żeby nie udawał aktualnego wyniku
+    if (!params.outputFile.empty() && !result.verify.empty() && result.verify != "ok") {
+        remove(params.outputFile.c_str());
+    } else if (!params.outputFile.empty()) {
+        int count = params.top > 0 ? min(params.top, size) : size;
+        if (perm) {
+            save_data(params.outputFile, arr, perm + size - count, count);
+        } else {
+            save_data(params.outputFile, arr + size - count, count);
+        }
+    }
+    delete[] perm;
+    return result;
+}
+
+// Tryb TEST
+template<typename T>
+RunResult run_test(const ProgramParams &params, AlgorithmType algorithmType, PivotType pivotType,
+                   vector<T> &buffer) {
+    buffer.resize(params.size);
+    T *arr = buffer.data();
+    generate_data(arr, params.size);
+    Timer verifyTimer;
+    uint64_t inputHash = 0;
+    if (params.verify) {
+        verifyTimer.start();
+        inputHash = multiset_hash(arr, nullptr, params.size, verifyThreads(params));
+        verifyTimer.stop();
+    }
+
+    Timer timer;
+    MemoryTracker memory;
+    unique_ptr<SortedContainer<T> > stream;
+    int rounds;
+    bool pinned;
+    {
+        ScopedCpuPin pin(params.measurement.cpu);
+        pinned = pin.pinned();
+        prepare_measurement(params.measurement, arr, params.size);
+
+        memory.start();
+        timer.start();
+        if (params.argsort) {
+            uint32_t *perm = run_argsort(arr, params.size, params, algorithmType, pivotType, rounds);
+            apply_permutation(arr, perm, params.size);
+            delete[] perm;
+        } else if (params.stream > 0) {
+            stream = run_stream(arr, params.size, params, algorithmType, pivotType, rounds);
+        } else {
+            rounds = run_sort(arr, params.size, params, algorithmType, pivotType);
+        }
+        timer.stop();
+        memory.stop();
+    }
+
+    RunResult result;
+    result.time_ms = timer.result();
+    result.memory = memory.result();
+    result.settings = applied_settings(params, pinned);
+    result.repair_rounds = rounds;
+    if (params.verify) {
+        verify_result(arr, nullptr, params.size, inputHash, params, verifyTimer,
+                      result, stream.get());
+    }
+    return result;
+}
+
+template<typename T>
+RunResult run_mode(const ProgramParams &params, AlgorithmType algorithmType, PivotType pivotType,
+                   JobBuffers &buffers) {
+    if (params.mode == "file") {
+        return run_file<T>(params, algorithmType, pivotType, buffers.get<T>());
+    }
+    return run_test<T>(params, algorithmType, pivotType, buffers.get<T>());
+}
+
+// Uruchamia zadanie --file/--test; niepoprawne parametry zgłaszane są jako invalid_argument
+RunResult run_job(const ProgramParams &params, JobBuffers &buffers) {
     AlgorithmType algorithmType;
     DataType dataType;
     PivotType pivotType = PivotType::RANDOM;
@@ -169,254 +709,231 @@ int main(int argc, char *argv[]) {
                 pivotType = static_cast<PivotType>(params.drunkenness);
             }
         }
-    } catch (const invalid_argument &e) {
-        cerr << "Nieprawidłowy format algorytmu lub typu danych." << endl;
-        showHelp();
-        return 1;
+    } catch (const logic_error &e) {
+        throw invalid_argument("Nieprawidłowy format algorytmu lub typu danych.");
+    }
+    if (algorithmType < INSERTION || algorithmType > DRUNK_QUICK || dataType < INT || dataType > BOARDGAME) {
+        throw invalid_argument("Nieprawidłowy format algorytmu lub typu danych.");
+    }
+    if (params.mode != "file" && params.mode != "test") {
+        throw invalid_argument("Nieznany tryb działania.");
+    }
+    if (params.pipeline && (params.top > 0 || params.argsort)) {
+        throw invalid_argument("--pipeline nie obsługuje --top ani --argsort.");
+    }
+    if (params.stream > 0 && (params.top > 0 || params.argsort || params.pipeline)) {
+        throw invalid_argument("--stream nie obsługuje --top, --argsort ani --pipeline.");
+    }
+    if (params.pipeline && params.verify) {
+        throw invalid_argument("--pipeline nie obsługuje --verify.");
+    }
+    // Potok wczytuje dane w trakcie pomiaru, więc nie ma tablicy do przygotowania przed startem Timera,
+    // a jego wątki odziedziczyłyby przypięcie do jednego rdzenia
+    if (params.pipeline && (params.measurement.cache != CacheMode::DEFAULT || params.measurement.prefault)) {
+        throw invalid_argument("--pipeline nie obsługuje --cold, --warm ani --prefault.");
+    }
+    if (params.pipeline && params.measurement.cpu >= 0) {
+        throw invalid_argument("--pipeline nie obsługuje --pin.");
     }
 
-    Timer timer;
-    if (params.mode == "file") {
-        // Tryb FILE
-        if (dataType == INT) {
-            int size;
-            auto *arr = load_data<int>(params.inputFile, size);
-            timer.start();
-
-            // Wybór algorytmu sortowania
-            switch (algorithmType) {
-                case INSERTION:
-                    insertion_sort(arr, size);
-                    break;
-                case HEAP:
-                    heap_sort(arr, size);
-                    break;
-                case SHELL:
-                    shell_sort(arr, size);
-                    break;
-                case QUICK:
-                    quick_sort(arr, 0, size - 1, pivotType);
-                    break;
-                case DRUNK_QUICK:
-                    drunk_heap_sort(arr, size, params.drunkenness);
-                    break;
-            }
-            timer.stop();
+    RunResult result;
+    switch (dataType) {
+        case INT:
+            result = run_mode<int>(params, algorithmType, pivotType, buffers);
+            break;
+        case FLOAT:
+            result = run_mode<float>(params, algorithmType, pivotType, buffers);
+            break;
+        case STRING:
+            result = run_mode<string>(params, algorithmType, pivotType, buffers);
+            break;
+        case BOARDGAME:
+            result = run_mode<BoardGame>(params, algorithmType, pivotType, buffers);
+            break;
+    }
+    return result;
+}
 
-            cout << timer.result() << endl;
+// Tryb BATCH
 
-            // Zapis do pliku wyjściowego (jeśli podano)
-            if (!params.outputFile.empty()) {
-                save_data(params.outputFile, arr, size);
-            }
-        } else if (dataType == FLOAT) {
-            int size;
-            auto *arr = load_data<float>(params.inputFile, size);
-            timer.start();
-
-            // Wybór algorytmu sortowania
-            switch (algorithmType) {
-                case INSERTION:
-                    insertion_sort(arr, size);
-                    break;
-                case HEAP:
-                    heap_sort(arr, size);
-                    break;
-                case SHELL:
-                    shell_sort(arr, size);
-                    break;
-                case QUICK:
-                    quick_sort(arr, 0, size - 1, pivotType);
-                    break;
-                case DRUNK_QUICK:
-                    drunk_heap_sort(arr, size, params.drunkenness);
-                    break;
-            }
-            timer.stop();
+// Odbiorca wyników jednego klienta: stdout albo połączenie przez gniazdo (zamykane po ostatnim wyniku)
+struct ResultSink {
+    ostream *stream{nullptr};
+    int fd{-1};
+    mutex lock;
 
-            cout << timer.result() << endl;
+    void send(const string &line) {
+        lock_guard<mutex> guard(lock);
+        if (stream) {
+            *stream << line << endl;
+        } else {
+            write_all(fd, line + "\n");
+        }
+    }
 
-            // Zapis do pliku wyjściowego (jeśli podano)
-            if (!params.outputFile.empty()) {
-                save_data(params.outputFile, arr, size);
-            }
-        } else if (dataType == STRING) {
-            int size;
-            auto *arr = load_data<std::string>(params.inputFile, size);
-            timer.start();
-
-            // Wybór algorytmu sortowania
-            switch (algorithmType) {
-                case INSERTION:
-                    insertion_sort(arr, size);
-                    break;
-                case HEAP:
-                    heap_sort(arr, size);
-                    break;
-                case SHELL:
-                    shell_sort(arr, size);
-                    break;
-                case QUICK:
-                    quick_sort(arr, 0, size - 1, pivotType);
-                    break;
-                case DRUNK_QUICK:
-                    drunk_heap_sort(arr, size, params.drunkenness);
-                    break;
-            }
-            timer.stop();
+    ~ResultSink() {
+        if (fd >= 0) close_fd(fd);
+    }
+};
 
-            cout << timer.result() << endl;
+struct BatchJob {
+    string line;
+    int number;                  // numer linii u danego klienta - domyślne id zadania
+    shared_ptr<ResultSink> sink;
+};
 
-            // Zapis do pliku wyjściowego (jeśli podano)
-            if (!params.outputFile.empty()) {
-                save_data(params.outputFile, arr, size);
-            }
-        } else if (dataType == BOARDGAME) {
-            int size;
-            auto *arr = load_data<BoardGame>(params.inputFile, size);
-            timer.start();
-
-            // Wybór algorytmu sortowania
-            switch (algorithmType) {
-                case INSERTION:
-                    insertion_sort(arr, size);
-                    break;
-                case HEAP:
-                    heap_sort(arr, size);
-                    break;
-                case SHELL:
-                    shell_sort(arr, size);
-                    break;
-                case QUICK:
-                    quick_sort(arr, 0, size - 1, pivotType);
-                    break;
-                case DRUNK_QUICK:
-                    drunk_heap_sort(arr, size, params.drunkenness);
-                    break;
-            }
-            timer.stop();
+ProgramParams parseJob(const JsonObject &job) {
+    const auto value = [&](const string &key) {
+        auto it = job.find(key);
+        return it == job.end() ? string() : it->second;
+    };
+    const auto number = [&](const string &key, int fallback) {
+        string text = value(key);
+        return text.empty() ? fallback : stoi(text);
+    };
 
-            cout << timer.result() << endl;
+    ProgramParams params;
+    params.algorithm = value("algorithm");
+    params.type = value("type");
+    params.inputFile = value("input");
+    params.outputFile = value("output");
+    params.mode = value("mode");
+    if (params.mode.empty()) {
+        params.mode = params.inputFile.empty() ? "test" : "file";
+    }
+    params.drunkenness = number("param", params.drunkenness);
+    params.size = number("size", 0);
+    params.seed = value("seed").empty() ? params.seed : stoull(value("seed"));
+    params.top = number("top", 0);
+    params.stream = number("stream", 0);
+    params.workers = number("workers", 0);
+    params.argsort = value("argsort") == "true";
+    params.prefix = value("prefix") == "true";
+    params.pipeline = value("pipeline") == "true";
+    params.verify = value("verify") == "true";
+    params.measurement.cpu = number("pin", -1);
+    if (!value("pin").empty() && params.measurement.cpu < 0) {
+        throw invalid_argument("pin musi być numerem rdzenia (>= 0).");
+    }
+    // prefault_heap() zmienia ustawienia alokatora dla całego procesu na stałe - serwer wsadowy ich nie przyjmuje
+    if (value("prefault") == "true") {
+        throw invalid_argument("prefault nie jest obsługiwany w trybie --batch.");
+    }
+    if (value("cache") == "cold") {
+        params.measurement.cache = CacheMode::COLD;
+    } else if (value("cache") == "warm") {
+        params.measurement.cache = CacheMode::WARM;
+    } else if (!value("cache").empty() && value("cache") != "default") {
+        throw invalid_argument("cache musi mieć wartość cold, warm albo default.");
+    }
+    params.stats = true;
+    if (params.mode == "test" && params.size <= 0) {
+        throw invalid_argument("Rozmiar musi być dodatnią liczbą całkowitą.");
+    }
+    return params;
+}
 
-            // Zapis do pliku wyjściowego (jeśli podano)
-            if (!params.outputFile.empty()) {
-                save_data(params.outputFile, arr, size);
-            }
+// shared_process - inne zadania działają równolegle, więc liczniki pamięci całego procesu nie są
+// przypisywalne do jednego zadania i trafiają do wyniku jako null.
+// Wyniki wracają w kolejności ukończenia, dlatego każdy niesie id zadania: pole "id" odesłane bez
+// zmiany typu, a gdy go brak (albo linia nie jest poprawnym JSON) - numer linii u danego klienta
+string processJob(const BatchJob &request, JobBuffers &buffers, bool shared_process) {
+    string id = to_string(request.number);
+    ostringstream out;
+    try {
+        JsonObject raw;
+        JsonObject job = parse_json_object(request.line, &raw);
+        if (raw.count("id")) id = raw["id"];
+        ProgramParams params = parseJob(job);
+        RunResult result = run_job(params, buffers);
+
+        out << "{\"id\":" << id << ",\"status\":\"ok\",\"time_ms\":" << result.time_ms;
+        if (shared_process) {
+            out << ",\"peak_rss_kb\":null,\"alloc_bytes\":null,\"peak_scratch_bytes\":null";
+        } else {
+            out << ",\"peak_rss_kb\":" << result.memory.peak_rss_kb
+                    << ",\"alloc_bytes\":" << result.memory.allocated_bytes
+                    << ",\"peak_scratch_bytes\":" << result.memory.peak_scratch_bytes;
         }
-    } else if (params.mode == "test") {
-        if (dataType == INT) {
-            int *arr = new int[params.size];
-            generate_data(arr, params.size);
-
-            timer.start();
-
-            // Wybór algorytmu sortowania
-            switch (algorithmType) {
-                case INSERTION:
-                    insertion_sort(arr, params.size);
-                    break;
-                case HEAP:
-                    heap_sort(arr, params.size);
-                    break;
-                case SHELL:
-                    shell_sort(arr, params.size);
-                    break;
-                case QUICK:
-                    quick_sort(arr, 0, params.size - 1, pivotType);
-                    break;
-                case DRUNK_QUICK:
-                    drunk_heap_sort(arr, params.size, params.drunkenness);
-                    break;
-            }
-            timer.stop();
-
-            cout << timer.result() << endl;
-            delete[] arr;
-        } else if (dataType == FLOAT) {
-            float *arr = new float[params.size];
-            generate_data(arr, params.size);
-            timer.start();
-
-            // Wybór algorytmu sortowania
-            switch (algorithmType) {
-                case INSERTION:
-                    insertion_sort(arr, params.size);
-                    break;
-                case HEAP:
-                    heap_sort(arr, params.size);
-                    break;
-                case SHELL:
-                    shell_sort(arr, params.size);
-                    break;
-                case QUICK:
-                    quick_sort(arr, 0, params.size - 1, pivotType);
-                    break;
-                case DRUNK_QUICK:
-                    drunk_heap_sort(arr, params.size, params.drunkenness);
-                    break;
-            }
-            timer.stop();
-
-            cout << timer.result() << endl;
-            delete[] arr;
-        } else if (dataType == STRING) {
-            string *arr = new string[params.size];
-            generate_data(arr, params.size);
-            timer.start();
-
-            // Wybór algorytmu sortowania
-            switch (algorithmType) {
-                case INSERTION:
-                    insertion_sort(arr, params.size);
-                    break;
-                case HEAP:
-                    heap_sort(arr, params.size);
-                    break;
-                case SHELL:
-                    shell_sort(arr, params.size);
-                    break;
-                case QUICK:
-                    quick_sort(arr, 0, params.size - 1, pivotType);
-                    break;
-                case DRUNK_QUICK:
-                    drunk_heap_sort(arr, params.size, params.drunkenness);
-                    break;
-            }
-            timer.stop();
-
-            cout << timer.result() << endl;
-            delete[] arr;
-        } else if (dataType == BOARDGAME) {
-            BoardGame *arr = new BoardGame[params.size];
-            generate_data(arr, params.size);
-            timer.start();
-
-            // Wybór algorytmu sortowania
-            switch (algorithmType) {
-                case INSERTION:
-                    insertion_sort(arr, params.size);
-                    break;
-                case HEAP:
-                    heap_sort(arr, params.size);
-                    break;
-                case SHELL:
-                    shell_sort(arr, params.size);
-                    break;
-                case QUICK:
-                    quick_sort(arr, 0, params.size - 1, pivotType);
-                    break;
-                case DRUNK_QUICK:
-                    drunk_heap_sort(arr, params.size, params.drunkenness);
-                    break;
+        out << ",\"max_depth\":" << result.memory.max_depth
+                << ",\"cpu\":" << result.settings.cpu
+                << ",\"cache\":\"" << cache_mode_name(result.settings.cache) << '"'
+                << ",\"prefault\":" << (result.settings.prefault ? "true" : "false")
+                << ",\"repair_rounds\":" << result.repair_rounds;
+        if (!result.verify.empty()) {
+            out << ",\"verify\":" << json_quote(result.verify) << ",\"verify_ms\":" << result.verify_ms;
+        }
+        if (result.pipelined) {
+            out << ",\"read_ms\":" << result.stages.read << ",\"sort_ms\":" << result.stages.sort
+                    << ",\"merge_ms\":" << result.stages.merge << ",\"write_ms\":" << result.stages.write;
+        }
+        out << "}";
+    } catch (const exception &e) {
+        out.str("");
+        out << "{\"id\":" << id << ",\"status\":\"error\",\"error\":" << json_quote(e.what()) << "}";
+    }
+    return out.str();
+}
+
+// Zadania z wielu źródeł trafiają do wspólnej kolejki obsługiwanej przez pulę wątków
+void runBatch(const ProgramParams &params) {
+    int workers = max(params.workers > 0 ? params.workers : static_cast<int>(thread::hardware_concurrency()), 1);
+    // Wątki klientów gniazda mogą przeżyć runBatch(), więc współdzielą kolejkę; po close() ich push() jest odrzucany
+    auto jobs = make_shared<BlockingQueue<BatchJob> >();
+
+    // Gniazdo powstaje przed pulą - błąd (np. zła ścieżka) nie zostawia niedołączonych wątków
+    unique_ptr<UnixServer> server;
+    if (!params.socketPath.empty()) {
+        server = make_unique<UnixServer>(params.socketPath);
+    }
+
+    vector<thread> pool;
+    for (int w = 0; w < workers; ++w) {
+        pool.emplace_back([jobs, workers] {
+            JobBuffers buffers;
+            while (auto job = jobs->pop()) {
+                job->sink->send(processJob(*job, buffers, workers > 1));
             }
-            timer.stop();
+        });
+    }
+
+    const auto is_blank = [](const string &line) {
+        return line.find_first_not_of(" \t\r") == string::npos;
+    };
 
-            cout << timer.result() << endl;
-            delete[] arr;
+    if (!server) {
+        auto sink = make_shared<ResultSink>();
+        sink->stream = &cout;
+        string line;
+        int number = 0;
+        while (getline(cin, line)) {
+            ++number;
+            if (!is_blank(line)) jobs->push({line, number, sink});
+        }
+    } else {
+        int client;
+        while ((client = server->accept_client()) >= 0) {
+            thread([client, jobs, is_blank] {
+                auto sink = make_shared<ResultSink>();
+                sink->fd = client;
+                FdLineReader reader(client);
+                string line;
+                int number = 0;
+                while (reader.next(line)) {
+                    ++number;
+                    if (!is_blank(line) && !jobs->push({line, number, sink})) break;
+                }
+            }).detach();
         }
     }
 
+    jobs->close();
+    for (auto &worker: pool) {
+        worker.join();
+    }
+}
 
+void complainAboutJava() {
     bool isJavaInstalled = false;
 
 #ifdef _WIN32
@@ -432,7 +949,43 @@ int main(int argc, char *argv[]) {
     if (isJavaInstalled) {
         cout << "Bleee Java. (Chyba że do Minecrafta to spoko jak nie to weź wyjdź)" << endl;
     }
+}
 
+int main(int argc, char *argv[]) {
+    ProgramParams params = parseArguments(argc, argv);
 
-    return 0;
+    if (params.mode == "help") {
+        showHelp();
+        return 0;
+    }
+
+    // W trybie BATCH stdout należy do wyników zadań
+    if (params.mode == "batch") {
+        try {
+            runBatch(params);
+        } catch (const exception &e) {
+            cerr << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    JobBuffers buffers;
+    RunResult result;
+    try {
+        result = run_job(params, buffers);
+        print_result(result, params);
+    } catch (const invalid_argument &e) {
+        cerr << e.what() << endl;
+        showHelp();
+        return 1;
+    }
+
+    if (!result.verify.empty()) {
+        cerr << "verify: " << result.verify << " (" << result.verify_ms << " ms)" << endl;
+    }
+
+    complainAboutJava();
+
+    return result.verify.empty() || result.verify == "ok" ? 0 : 2;
 }
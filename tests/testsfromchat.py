@@ -1,4 +1,5 @@
 # ANSI color codes that work on macOS
+import json
 import os
 import random
 import subprocess
@@ -55,14 +56,18 @@ def create_test_files():
             complexity = random.randint(1, 5)
             joy = random.randint(1, 10)
             f.write(f"{game},{publisher},{min_p},{max_p},{time},{complexity},{joy}\n")
-def run_test_case(cmd, description, check_output=False):
+def run_test_case(cmd, description, check_output=False, expect_failure=False):
     global passed_count, failed_count
 
     color_print(f"Running test: {description}", BLUE)
     result = subprocess.run(cmd, capture_output=True, text=True)
 
     success = False
-    if result.returncode == 0:
+    if expect_failure:
+        success = result.returncode != 0
+        if not success:
+            color_print("Expected a non-zero exit code", YELLOW)
+    elif result.returncode == 0:
         if check_output:
             output = result.stdout.strip()
             if output.replace('.', '', 1).isdigit():
@@ -84,6 +89,19 @@ def run_test_case(cmd, description, check_output=False):
     return success
 
 
+def mark_failed(description, reason):
+    # Turns an already counted PASSED run into a failure after checking its output
+    global passed_count, failed_count
+    color_print(f"FAILED: {description} - {reason}", RED)
+    passed_count -= 1
+    failed_count += 1
+
+
+def read_values(filename, parse=str):
+    with open(filename) as f:
+        return [parse(line.rstrip("\n")) for line in f.readlines()[1:]]
+
+
 def test_valid_scenarios():
     algorithms = {0: "Insertion", 1: "Heap", 2: "Shell", 3: "Quick", 4: "Drunk_Ins"}
     data_types = {0: "int", 1: "float", 2: "string", 3: "BoardGame"}
@@ -118,6 +136,167 @@ def test_valid_scenarios():
                           f"TEST {algo_name} sort with {data_type}", check_output=True)
 
 
+def test_stream_scenarios():
+    algorithms = {1: "Heap", 3: "Quick", 4: "Drunk_Ins"}
+    parsers = {0: ("int", int), 1: ("float", float), 2: ("string", str)}
+
+    # --stream: insert one by one into SortedContainer, for_each back; must equal a full sort
+    for algo_num, algo_name in algorithms.items():
+        for data_num, (data_type, parse) in parsers.items():
+            input_file = f"input_{data_type}.txt"
+            output_file = f"output_stream_{algo_name}_{data_type}.txt"
+            cmd = ["./aizo1", "--file", str(algo_num), str(data_num), input_file, output_file,
+                   "--stream", "8", "--verify"]
+            description = f"STREAM {algo_name} sort with {data_type}"
+            if not run_test_case(cmd, description):
+                continue
+
+            if read_values(output_file, parse) != sorted(read_values(input_file, parse)):
+                mark_failed(description, "output differs from a full sort")
+
+    # range() on the container is checked by --verify in --test mode
+    for data_num, data_type in {0: "int", 3: "BoardGame"}.items():
+        run_test_case(["./aizo1", "--test", "3", str(data_num), "1000", "--stream", "16", "--verify"],
+                      f"STREAM range query with {data_type}")
+
+
+def test_top_scenarios():
+    algorithms = {0: "Insertion", 1: "Heap", 3: "Quick", 4: "Drunk_Ins"}
+    parsers = {0: ("int", int), 1: ("float", float), 2: ("string", str)}
+
+    # --top K: the output holds the K largest values ascending (all of them when K >= n)
+    for algo_num, algo_name in algorithms.items():
+        for data_num, (data_type, parse) in parsers.items():
+            input_file = f"input_{data_type}.txt"
+            expected_all = sorted(read_values(input_file, parse))
+            for k in (5, len(expected_all), 100):
+                output_file = f"output_top_{algo_name}_{data_type}_{k}.txt"
+                cmd = ["./aizo1", "--file", str(algo_num), str(data_num), input_file, output_file,
+                       "--top", str(k), "--verify"]
+                description = f"TOP {k} {algo_name} with {data_type}"
+                if not run_test_case(cmd, description):
+                    continue
+
+                if read_values(output_file, parse) != expected_all[-k:]:
+                    mark_failed(description, f"output is not the {k} largest values")
+
+
+def test_argsort_scenarios():
+    # Deterministic algorithms make the same comparisons on indices as on records, so --argsort
+    # must write exactly the plain --file output (also for BoardGame with equal fun factors)
+    algorithms = {0: "Insertion", 1: "Heap", 2: "Shell"}
+    input_files = {0: "input_int.txt", 1: "input_float.txt", 2: "input_string.txt", 3: "input_boardgame.txt"}
+
+    for algo_num, algo_name in algorithms.items():
+        for data_num, input_file in input_files.items():
+            plain_file = f"output_plain_{algo_name}_{data_num}.txt"
+            argsort_file = f"output_argsort_{algo_name}_{data_num}.txt"
+            subprocess.run(["./aizo1", "--file", str(algo_num), str(data_num), input_file, plain_file],
+                           capture_output=True)
+            cmd = ["./aizo1", "--file", str(algo_num), str(data_num), input_file, argsort_file,
+                   "--argsort", "--verify"]
+            description = f"ARGSORT {algo_name} sort with {input_file}"
+            if not run_test_case(cmd, description):
+                continue
+
+            if not os.path.exists(plain_file):
+                mark_failed(description, "plain run wrote no output")
+            elif read_values(argsort_file) != read_values(plain_file):
+                mark_failed(description, "output differs from a plain sort")
+
+    # --test applies the permutation in place; --verify checks the records
+    for data_num, data_type in {0: "int", 3: "BoardGame"}.items():
+        run_test_case(["./aizo1", "--test", "3", str(data_num), "1000", "--argsort", "--verify"],
+                      f"ARGSORT in-place permutation with {data_type}")
+
+
+def test_prefix_scenarios():
+    # Strings sharing the 8-byte prefix, shorter than it and duplicated, so ties go through the
+    # length check and the comparison from the 9th byte
+    words = ["abcdefgh", "abcdefghij", "abcdefgh1", "abcdefghi", "abc", "abcd", "abcdefgg", "b", "zz",
+             "abcdefghijklmnop", "abcdefghijklmnoo", "Abcdefgh"]
+    prefix_data = [random.choice(words) for _ in range(200)]
+    with open("input_prefix.txt", "w") as f:
+        f.write(f"{len(prefix_data)}\n")
+        for word in prefix_data:
+            f.write(f"{word}\n")
+
+    algorithms = {0: "Insertion", 1: "Heap", 2: "Shell", 3: "Quick", 4: "Drunk_Ins"}
+    for algo_num, algo_name in algorithms.items():
+        for input_file in ("input_string.txt", "input_prefix.txt"):
+            output_file = f"output_prefix_{algo_name}_{input_file}"
+            cmd = ["./aizo1", "--file", str(algo_num), "2", input_file, output_file, "--prefix", "--verify"]
+            description = f"PREFIX {algo_name} sort with {input_file}"
+            if not run_test_case(cmd, description):
+                continue
+
+            if read_values(output_file) != sorted(read_values(input_file)):
+                mark_failed(description, "output differs from a full sort")
+
+
+def test_pipeline_scenarios():
+    # Deterministic algorithms: the pipelined output must be identical to the sequential --file output
+    algorithms = {0: "Insertion", 1: "Heap", 2: "Shell"}
+    input_files = {0: "input_int.txt", 1: "input_float.txt", 2: "input_string.txt", 3: "input_boardgame.txt"}
+
+    for algo_num, algo_name in algorithms.items():
+        for data_num, input_file in input_files.items():
+            sequential_file = f"output_sequential_{algo_name}_{data_num}.txt"
+            pipeline_file = f"output_pipeline_{algo_name}_{data_num}.txt"
+            subprocess.run(["./aizo1", "--file", str(algo_num), str(data_num), input_file, sequential_file],
+                           capture_output=True)
+            cmd = ["./aizo1", "--file", str(algo_num), str(data_num), input_file, pipeline_file,
+                   "--pipeline", "--workers", "2"]
+            description = f"PIPELINE {algo_name} sort with {input_file}"
+            if not run_test_case(cmd, description):
+                continue
+
+            if not os.path.exists(sequential_file):
+                mark_failed(description, "sequential run wrote no output")
+            elif read_values(pipeline_file) != read_values(sequential_file):
+                mark_failed(description, "output differs from the sequential --file output")
+
+
+def check(success, description, reason):
+    global passed_count, failed_count
+    if success:
+        color_print(f"PASSED: {description}", GREEN)
+        passed_count += 1
+    else:
+        color_print(f"FAILED: {description} - {reason}", RED)
+        failed_count += 1
+
+
+def test_batch_scenarios():
+    # One worker reuses its buffers: the short file (header 5, one record) must not pick up
+    # records of the previous job
+    with open("input_short.txt", "w") as f:
+        f.write("5\nzzz\n")
+    jobs = [
+        '{"id": 1, "algorithm": 1, "type": 2, "input": "input_string.txt", "output": "output_batch_long.txt"}',
+        '{"id": 2, "algorithm": 1, "type": 2, "input": "input_short.txt", "output": "output_batch_short.txt"}',
+        '{"id": 3, "algorithm": 9, "type": 0, "size": 10}',
+        '{"algorithm": 3, "type": 0, "size": 100, "verify": true}',
+    ]
+
+    color_print("Running test: BATCH jobs from stdin", BLUE)
+    result = subprocess.run(["./aizo1", "--batch", "--workers", "1"], input="\n".join(jobs) + "\n",
+                            capture_output=True, text=True)
+    try:
+        responses = {response["id"]: response for response in map(json.loads, result.stdout.splitlines())}
+    except ValueError:
+        responses = {}
+    check(result.returncode == 0 and len(responses) == len(jobs), "BATCH one result per job",
+          f"rc={result.returncode}, output:\n{result.stdout}")
+    check(responses.get(1, {}).get("status") == "ok", "BATCH ok job", str(responses.get(1)))
+    check(responses.get(3, {}).get("status") == "error", "BATCH error job", str(responses.get(3)))
+    check(responses.get(4, {}).get("verify") == "ok", "BATCH job without id answered with its line number",
+          str(responses.get(4)))
+    short = read_values("output_batch_short.txt") if os.path.exists("output_batch_short.txt") else None
+    check(short is not None and sorted(short) == ["", "", "", "", "zzz"], "BATCH short file does not reuse old records",
+          str(short))
+
+
 def test_invalid_scenarios():
     # Test help mode
     run_test_case(["./aizo1", "--help"], "Help mode")
@@ -129,13 +308,15 @@ def test_invalid_scenarios():
     # Invalid algorithm
     run_test_case(
         ["./aizo1", "--file", "5", "0", "input_int.txt", "output.txt"],
-        "Invalid algorithm"
+        "Invalid algorithm",
+        expect_failure=True
     )
 
     # Invalid data type
     run_test_case(
         ["./aizo1", "--file", "0", "4", "input_int.txt", "output.txt"],
-        "Invalid data type"
+        "Invalid data type",
+        expect_failure=True
     )
 
     # Insufficient arguments for --file
@@ -162,6 +343,24 @@ def main():
     color_print("\n=== Testing valid scenarios ===", BLUE)
     test_valid_scenarios()
 
+    color_print("\n=== Testing stream scenarios ===", BLUE)
+    test_stream_scenarios()
+
+    color_print("\n=== Testing top-k scenarios ===", BLUE)
+    test_top_scenarios()
+
+    color_print("\n=== Testing argsort scenarios ===", BLUE)
+    test_argsort_scenarios()
+
+    color_print("\n=== Testing prefix scenarios ===", BLUE)
+    test_prefix_scenarios()
+
+    color_print("\n=== Testing pipeline scenarios ===", BLUE)
+    test_pipeline_scenarios()
+
+    color_print("\n=== Testing batch scenarios ===", BLUE)
+    test_batch_scenarios()
+
     color_print("\n=== Testing invalid scenarios ===", BLUE)
     test_invalid_scenarios()
 